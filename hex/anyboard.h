@@ -0,0 +1,249 @@
+#ifndef __HEXANYBOARD_H__
+#define __HEXANYBOARD_H__ 1
+#include <cmath>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "panic.h"
+#include "board.h"
+#include "winner.h"
+#include "search.h"
+
+// An AnyBoard is a Board whose size is chosen at run time, for programs that
+// read positions of several sizes from files or requests. It holds a
+// Board<N> for one N from 1 to maxSize, and each of its methods calls the
+// same method of that Board<N>, so the work is done by the kernels compiled
+// for that size.
+//
+// The methods dispatch through a table of functions with one entry per size:
+// an AnyBoard keeps a pointer to its size's entry, so each call costs one
+// indirect call and no branching on the size. A loop that calls many
+// methods on boards of one size can instead get the Board<N> itself, with
+// board<N>(), and call its methods directly.
+class AnyBoard {
+public:
+  static constexpr int maxSize = 13; // The largest board an AnyBoard holds.
+
+  // AnyBoard(size) creates an empty size×size board, with X to play.
+  // Panics unless 1 ≤ size ≤ maxSize.
+  explicit AnyBoard(int size) : ops(opsFor(size)) {
+    ops->construct(&storage, nullptr);
+  }
+
+  // AnyBoard(size, content) creates a size×size board from a textual
+  // representation of a game state, as Board<size>(content) does.
+  AnyBoard(int size, std::string content) : ops(opsFor(size)) {
+    ops->construct(&storage, &content);
+  }
+
+  // AnyBoard(content) is AnyBoard(size, content), for the size whose square
+  // is the number of cells (non-whitespace characters) in content.
+  // Panics if there is no such size from 1 to maxSize.
+  explicit AnyBoard(std::string content)
+      : AnyBoard(sizeOf(content), content) { }
+
+  // AnyBoard(b) holds a copy of b.
+  template<bitpos N>
+  AnyBoard(const Board<N> &b) : ops(opsFor(N)) {
+    static_assert(N >= 1 && N <= maxSize,
+        "AnyBoard(Board<N>): N must be from 1 to maxSize");
+    new (&storage) Board<N>(b);
+  }
+
+  AnyBoard(const AnyBoard &b) : ops(b.ops) {
+    ops->copy(&storage, &b.storage);
+  }
+
+  AnyBoard &operator=(const AnyBoard &b) {
+    if (this == &b) {
+      return *this;
+    }
+    ops = b.ops;
+    ops->copy(&storage, &b.storage);
+    return *this;
+  }
+
+  // Returns the edge length of the board.
+  int size() const { return ops->size; }
+
+  // Returns the number of cells on the board.
+  int count() const { return ops->size * ops->size; }
+
+  // These are as for Board<N>.
+  char player() const { return ops->player(&storage); }
+  char opponent() const { return 'X' + 'O' - player(); }
+  uint64_t hash() const { return ops->hash(&storage); }
+  std::string stateString() const { return ops->stateString(&storage); }
+
+  AnyBoard &go(int at) {
+    ops->go(&storage, at);
+    return *this;
+  }
+
+  AnyBoard &undo(int at) {
+    ops->undo(&storage, at);
+    return *this;
+  }
+
+  char winner(char testFor='?') const {
+    return ops->winner(&storage, testFor);
+  }
+
+  char virtualWinner(char testFor='?') const {
+    return ops->virtualWinner(&storage, testFor);
+  }
+
+  // search(cells) runs search() on the board, and returns the winner. If
+  // cells is not null, it receives the cells of the winning pattern.
+  char search(std::vector<bitpos> *cells = nullptr) const {
+    return ops->search(&storage, cells);
+  }
+
+  std::ostream &Render(std::ostream &w) const {
+    return ops->render(&storage, w);
+  }
+
+  // board<N>() returns the Board<N> that this AnyBoard holds. Panics unless
+  // N is size().
+  template<bitpos N>
+  Board<N> &board() {
+    checkSize(N);
+    return *reinterpret_cast< Board<N>* >(&storage);
+  }
+
+  template<bitpos N>
+  const Board<N> &board() const {
+    checkSize(N);
+    return *reinterpret_cast< const Board<N>* >(&storage);
+  }
+
+  bool operator==(const AnyBoard &other) const {
+    return ops == other.ops && ops->equal(&storage, &other.storage);
+  }
+
+  bool operator!=(const AnyBoard &other) const {
+    return !this->operator==(other);
+  }
+
+private:
+  // Ops is the table entry for one size: the Board<N> methods, as functions
+  // of the storage that holds the Board<N>.
+  struct Ops {
+    int size;
+    void (*construct)(void *to, const std::string *content);
+    void (*copy)(void *to, const void *from);
+    char (*player)(const void *b);
+    uint64_t (*hash)(const void *b);
+    std::string (*stateString)(const void *b);
+    void (*go)(void *b, int at);
+    void (*undo)(void *b, int at);
+    char (*winner)(const void *b, char testFor);
+    char (*virtualWinner)(const void *b, char testFor);
+    char (*search)(const void *b, std::vector<bitpos> *cells);
+    std::ostream &(*render)(const void *b, std::ostream &w);
+    bool (*equal)(const void *a, const void *b);
+  };
+
+  // OpsOf<N> holds the functions of the table entry for size N.
+  template<bitpos N>
+  struct OpsOf {
+    static const Board<N> &of(const void *b) {
+      return *static_cast< const Board<N>* >(b);
+    }
+    static Board<N> &of(void *b) { return *static_cast< Board<N>* >(b); }
+
+    static void construct(void *to, const std::string *content) {
+      if (content == nullptr) {
+        new (to) Board<N>();
+      } else {
+        new (to) Board<N>(*content);
+      }
+    }
+    static void copy(void *to, const void *from) {
+      new (to) Board<N>(of(from));
+    }
+    static char player(const void *b) { return of(b).player(); }
+    static uint64_t hash(const void *b) { return of(b).hash(); }
+    static std::string stateString(const void *b) {
+      return of(b).stateString();
+    }
+    static void go(void *b, int at) { of(b).go(at); }
+    static void undo(void *b, int at) { of(b).undo(at); }
+    static char winner(const void *b, char testFor) {
+      return of(b).winner(testFor);
+    }
+    static char virtualWinner(const void *b, char testFor) {
+      return of(b).virtualWinner(testFor);
+    }
+    static char search(const void *b, std::vector<bitpos> *cells) {
+      Pattern<N> via;
+      const char w = ::search(of(b), via);
+      if (cells != nullptr) {
+        const cellset<N> body = via.cells();
+        cells->assign(body.begin(), body.end());
+      }
+      return w;
+    }
+    static std::ostream &render(const void *b, std::ostream &w) {
+      return of(b).Render(w);
+    }
+    static bool equal(const void *a, const void *b) { return of(a) == of(b); }
+
+    static constexpr Ops ops() {
+      return Ops{N, construct, copy, player, hash, stateString, go, undo,
+                 winner, virtualWinner, search, render, equal};
+    }
+  };
+
+  // Storage is big enough, and aligned, for a Board of any size up to
+  // maxSize, which is the largest.
+  typedef std::aligned_storage<sizeof(Board<maxSize>),
+                               alignof(Board<maxSize>)>::type Storage;
+
+  const Ops *ops;
+  Storage storage;
+
+  // Returns the table entry for size. Panics unless 1 ≤ size ≤ maxSize.
+  static const Ops *opsFor(int size) {
+    static const Ops table[maxSize] = {
+      OpsOf<1>::ops(), OpsOf<2>::ops(), OpsOf<3>::ops(), OpsOf<4>::ops(),
+      OpsOf<5>::ops(), OpsOf<6>::ops(), OpsOf<7>::ops(), OpsOf<8>::ops(),
+      OpsOf<9>::ops(), OpsOf<10>::ops(), OpsOf<11>::ops(), OpsOf<12>::ops(),
+      OpsOf<13>::ops(),
+    };
+    if (1 <= size && size <= maxSize) {
+      return &table[size - 1];
+    }
+    panic("AnyBoard: size is %d; must be between 1 and %d", size, maxSize);
+    return &table[0]; // Not reached, but panic() is not marked noreturn.
+  }
+
+  // Returns the size whose square is the number of non-whitespace
+  // characters in content. Panics if there is none from 1 to maxSize.
+  static int sizeOf(const std::string &content) {
+    int cells = 0;
+    for (char c : content) {
+      cells += !isBoardSpace(c);
+    }
+    const int size = int(std::lround(std::sqrt(double(cells))));
+    if (size * size != cells || size < 1 || size > maxSize) {
+      panic("AnyBoard(content): %d cells is not a square board of size "
+          "1 to %d", cells, maxSize);
+    }
+    return size;
+  }
+
+  void checkSize(int n) const {
+    if (n != ops->size) {
+      panic("AnyBoard.board<%d>(): the board's size is %d", n, ops->size);
+    }
+  }
+};
+
+inline std::ostream& operator<< (std::ostream &w, const AnyBoard &board) {
+  return board.Render(w);
+}
+
+#endif /* __HEXANYBOARD_H__ */
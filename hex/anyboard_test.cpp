@@ -0,0 +1,106 @@
+#include <sstream>
+#include <vector>
+#include "anyboard.h"
+#include "randomgame.h"
+#include "gtest/gtest.h"
+
+
+// TEST has two parameters: the test case name and the test name.
+// The test case name and the test name should both be valid C++
+// identifiers.  And you should not use underscore (_) in the names.
+
+// Plays a random game on an AnyBoard and on a Board<N>, checking after every
+// move that they agree, then undoes it.
+template<bitpos N>
+void testDispatch() {
+  const std::vector<int> cells = randomGame<N>(N);
+
+  AnyBoard any(N);
+  Board<N> b;
+  ASSERT_EQ(N, any.size());
+  ASSERT_EQ(N*N, any.count());
+  for (int cell : cells) {
+    any.go(cell);
+    b.go(cell);
+    ASSERT_EQ(b.player(), any.player()) << N;
+    ASSERT_EQ(b.hash(), any.hash()) << N;
+    ASSERT_EQ(b.stateString(), any.stateString()) << N;
+    ASSERT_EQ(b.winner(), any.winner()) << N;
+    ASSERT_EQ(b.winner('O'), any.winner('O')) << N;
+    ASSERT_EQ(b.virtualWinner(), any.virtualWinner()) << N;
+    ASSERT_EQ(b, any.template board<N>()) << N;
+  }
+  for (auto it = cells.rbegin(); it != cells.rend(); ++it) {
+    any.undo(*it);
+  }
+  EXPECT_EQ(AnyBoard(N), any);
+  EXPECT_EQ(AnyBoard(Board<N>()), any);
+}
+
+TEST(AnyBoard, Dispatch) {
+  testDispatch<1>();
+  testDispatch<2>();
+  testDispatch<3>();
+  testDispatch<4>();
+  testDispatch<5>();
+  testDispatch<6>();
+  testDispatch<7>();
+  testDispatch<8>();
+  testDispatch<9>();
+  testDispatch<10>();
+  testDispatch<11>();
+  testDispatch<12>();
+  testDispatch<13>();
+}
+
+TEST(AnyBoard, Content) {
+  AnyBoard b(R"(- X -
+                 - X O
+                  - X O)");
+  EXPECT_EQ(3, b.size());
+  EXPECT_EQ('O', b.player());
+  EXPECT_EQ('X', b.winner());
+  EXPECT_EQ(Board<3>("-X--XO-XO"), b.board<3>());
+  EXPECT_EQ(AnyBoard(3, "-X--XO-XO"), b);
+  EXPECT_NE(AnyBoard(3), b);
+  EXPECT_NE(AnyBoard(4), AnyBoard(3));
+
+  std::ostringstream any, fixed;
+  any << b;
+  fixed << Board<3>("-X--XO-XO");
+  EXPECT_EQ(fixed.str(), any.str());
+
+  // Copies are independent, and may be of another size.
+  AnyBoard copy = b;
+  copy.undo(7);
+  EXPECT_EQ('?', copy.winner());
+  EXPECT_EQ('X', b.winner());
+  copy = AnyBoard(11);
+  EXPECT_EQ(11, copy.size());
+  EXPECT_EQ(121, copy.board<11>().count);
+  const AnyBoard &same = copy;
+  copy.go(60);
+  copy = same;
+  EXPECT_EQ('O', copy.player());
+  EXPECT_EQ(Board<11>().go(60), copy.board<11>());
+
+  EXPECT_THROW(AnyBoard(0), Panic);
+  EXPECT_THROW(AnyBoard(14), Panic);
+  EXPECT_THROW(AnyBoard("XO"), Panic);
+  EXPECT_THROW(AnyBoard(std::string(14*14, '-')), Panic);
+  EXPECT_THROW(AnyBoard(3, "----"), Panic);
+  EXPECT_THROW(b.board<4>(), Panic);
+}
+
+TEST(AnyBoard, Search) {
+  Board<3> b;
+  b.go(4);
+  Pattern<3> patt;
+  const char expected = search(b, patt);
+
+  std::vector<bitpos> cells;
+  EXPECT_EQ(expected, AnyBoard(b).search(&cells));
+  const cellset<3> body = patt.cells();
+  EXPECT_EQ(std::vector<bitpos>(body.begin(), body.end()), cells);
+  EXPECT_EQ('X', AnyBoard(2).search());
+}
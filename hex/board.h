@@ -8,10 +8,57 @@
 #include <map>
 #include "panic.h"
 #include "cellset.h"
+#include "connectivity.h"
+#include "cellchars.h"
 
 template<bitpos N>
 using PrintMap = std::map< char, cellset<N> >;
 
+// ZobristKeys holds the random keys from which Board hashes are built: one
+// for each cell of the largest board and each player, and one for the
+// horizontal player having the move. A board's hash is the xor of the keys of
+// its owned cells and, if O is to move, of horizontalToMove, so a move
+// changes it by two xors. The keys come from the SplitMix64 generator, at
+// compile time.
+struct ZobristKeys {
+  uint64_t cell[2][19*19]; // cell[0] is for X's cells, cell[1] for O's.
+  uint64_t horizontalToMove;
+
+  constexpr ZobristKeys() : cell{}, horizontalToMove(0) {
+    uint64_t state = 0x5A0B215748C0F7E1ULL;
+    for (int player = 0; player < 2; ++player) {
+      for (int i = 0; i < 19*19; ++i) {
+        cell[player][i] = next(state);
+      }
+    }
+    horizontalToMove = next(state);
+  }
+
+private:
+  static constexpr uint64_t next(uint64_t &state) {
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+};
+
+constexpr ZobristKeys zobristKeys{};
+
+// The symmetries of a Hex board that preserve the game. ROTATE180 turns the
+// board half way around, and each player keeps their edges. TRANSPOSE and
+// ANTI_TRANSPOSE reflect the board in one of its diagonals (see
+// cellset.transpose()), which exchanges the vertical player's edges with the
+// horizontal player's, so they also exchange the players: X's cells become
+// O's, and if X was to move, O is. Each symmetry is its own inverse.
+enum Symmetry { IDENTITY, ROTATE180, TRANSPOSE, ANTI_TRANSPOSE };
+
+// Returns whether symmetry s exchanges the players.
+inline constexpr bool swapsPlayers(Symmetry s) {
+  return s == TRANSPOSE || s == ANTI_TRANSPOSE;
+}
+
 // A Board represents the state of a Hex game, including information about
 // whose turn it is to play, and which cells are owned by each player.
 template<bitpos N>
@@ -26,10 +73,12 @@ private:
   char play; // 'X' if vertical to play, 'O' if horizontal
   cellSet vert; // Bitset of cells owned by the vertical player.
   cellSet horz; // Bitset of cells owned by the horizontal player.
+  uint64_t key; // Zobrist hash of the position (see ZobristKeys).
+  Connectivity<N> *tracker; // If not null, follows the moves (see track()).
 
 public:
   // Board() creates an empty board, with X to play.
-  Board() : play('X'), vert{0}, horz{0} { }
+  Board() : play('X'), vert{0}, horz{0}, key(0), tracker(nullptr) { }
 
   // Board(string) creates a game from a textual representation of a game
   // state.  The string may contain whitespace, which is ignored, and that
@@ -65,14 +114,70 @@ public:
   //     `)
   // board1 and board2 represent exactly the same game state, and that state is
   // the left-leaning board shown by board1's state string.
-  Board(std::string content);
+  Board(const std::string &content)
+      : Board(parse(content.data(), content.size())) { }
+
+  // parse(text, length) returns the board that Board(content) makes of the
+  // length characters at text, without copying them. If there is no
+  // whitespace, it classifies the characters with classifyCells(), which is
+  // the case that it is fastest for.
+  static Board<N> parse(const char *text, size_t length);
+
+  // parseState(text, length) returns the board whose stateString() is the
+  // length characters at text: the player to move, a colon, and count cell
+  // characters. Panics if the text is not of that form.
+  static Board<N> parseState(const char *text, size_t length);
+
+  // parseStates(text, length, out) parses each line of the length characters
+  // at text with parseState(), writing the boards to out, and returns the
+  // number of boards. Lines end with '\n'; a '\r' before it is ignored, as
+  // are empty lines. out must have room for a board per line. Panics, giving
+  // the line number, if a line is not a state string.
+  static size_t parseStates(const char *text, size_t length, Board<N> *out);
+
+  // Board(vertical, horizontal, player) creates a game in which the vertical
+  // and horizontal players own the given cells, and it is player's turn.
+  // Panics if a cell is owned by both, or if player is not 'X' or 'O'.
+  Board(cellSet vertical, cellSet horizontal, char player)
+      : play('X'), vert(vertical), horz(horizontal), key(0),
+        tracker(nullptr) {
+    if (vert.intersects(horz)) {
+      panic("Board(vertical, horizontal, player): both own %s",
+          (vert & horz).to_string().c_str());
+    }
+    key = computeHash();
+    setPlayer(player);
+  }
 
-  Board(const Board &b) : play(b.play), vert(b.vert), horz(b.horz) { }
+  // A copy of a board is not tracked (see track()), since a Connectivity
+  // follows the moves of a single Board.
+  Board(const Board &b)
+      : play(b.play), vert(b.vert), horz(b.horz), key(b.key),
+        tracker(nullptr) { }
 
+  // Assignment keeps this board's tracker, if any, and resets it to the new
+  // position.
   Board &operator=(const Board &b) {
     this->play = b.play;
     this->vert = b.vert;
     this->horz = b.horz;
+    this->key = b.key;
+    if (tracker != nullptr) {
+      tracker->reset(vert, horz);
+    }
+    return *this;
+  }
+
+  // track(c) makes c follow this board: it resets c to the current position,
+  // and from then on go() and undo() update c, and winner() asks c instead of
+  // flooding the board. track(nullptr) stops that. Tracking makes winner()
+  // cheap after each move, at the cost of a few union-find steps in go(), so
+  // it suits a search that calls winner() after every move.
+  Board<N>& track(Connectivity<N> *c) {
+    tracker = c;
+    if (tracker != nullptr) {
+      tracker->reset(vert, horz);
+    }
     return *this;
   }
 
@@ -86,6 +191,9 @@ public:
   // Set the current player. Argument must be 'X' or 'O'.
   Board<N>& setPlayer(char newPlayer) {
     if (newPlayer == 'X' || newPlayer == 'O') {
+      if (newPlayer != play) {
+        key ^= zobristKeys.horizontalToMove;
+      }
       play = newPlayer;
     } else {
       panic("Board.setPlayer(p): p must be 'X' or 'O'; was '%c'\n", newPlayer);
@@ -113,13 +221,61 @@ public:
       panic("Board.play(%d) by %c: O already owns that cell", at, play);
     }
 
+    if (tracker != nullptr) {
+      tracker->go(at, play);
+    }
     if (play == 'X') {
       vert.set(at);
       play = 'O';
+      key ^= zobristKeys.cell[0][at];
     } else {
       horz.set(at);
       play = 'X';
+      key ^= zobristKeys.cell[1][at];
+    }
+    key ^= zobristKeys.horizontalToMove;
+#ifdef BOARD_VERIFY_HASH
+    verifyHash("Board.go()");
+#endif
+
+    return *this;
+  }
+
+  // undo(at) reverses go(at): it updates the Board to represent the game
+  // state before the last player claimed the named cell, restoring the
+  // player() and the hash(). Moves must be undone in the reverse of the order
+  // in which they were played, which lets a search explore a tree of moves
+  // with a single Board, instead of copying it for each move.
+  //
+  // Panics if `at` is an illegal index, or if `at` is not owned by the
+  // opponent() (who claimed the last cell).
+  Board<N>& undo(int at) {
+    if (at < 0 || at > max) {
+      panic("Board.undo(%d): cell numbers must be between 0 and %d", at, max);
+    }
+
+    if (!(play == 'O' ? vert : horz).test(at)) {
+      panic("Board.undo(%d): %c does not own that cell", at, opponent());
+    }
+
+    // The tracker panics unless at was the last move, so it goes first, as in
+    // go(), to leave the board unchanged if it does.
+    if (tracker != nullptr) {
+      tracker->undo(at);
+    }
+    if (play == 'O') {
+      vert.reset(at);
+      play = 'X';
+      key ^= zobristKeys.cell[0][at];
+    } else {
+      horz.reset(at);
+      play = 'O';
+      key ^= zobristKeys.cell[1][at];
     }
+    key ^= zobristKeys.horizontalToMove;
+#ifdef BOARD_VERIFY_HASH
+    verifyHash("Board.undo()");
+#endif
 
     return *this;
   }
@@ -145,8 +301,248 @@ public:
   static inline constexpr cellSet leftColumn() { return cellSet::left(); }
   static inline constexpr cellSet rightColumn() { return cellSet::right(); }
 
-  std::string stateString() const;
-  std::string reverseStateString() const;
+  // subBoard<K>(row, col) returns the K×K part of this board with cell
+  // (row, col) at its top left, and the same player to move. The sub-board's
+  // own edges stand in for the real ones, so its winner() tells whether a
+  // player connects across that window; a K of 8 or less gives a board whose
+  // cellsets are a single quadword. Panics unless the window fits.
+  template<bitpos K>
+  Board<K> subBoard(bitpos row, bitpos col) const {
+    return Board<K>(vert.template crop<K>(row, col),
+                    horz.template crop<K>(row, col), play);
+  }
+
+  // embed(part, row, col) replaces the K×K part of this board with cell
+  // (row, col) at its top left by the cells of part, the inverse of
+  // subBoard<K>(row, col). The player to move is unchanged.
+  template<bitpos K>
+  Board<N>& embed(const Board<K> &part, bitpos row, bitpos col) {
+    const cellSet window = cellSet::rectangle(row, col, K, K);
+    vert = (vert - window) | cellSet::embed(part.verticalCells(), row, col);
+    horz = (horz - window) | cellSet::embed(part.horizontalCells(), row, col);
+    key = computeHash();
+    if (tracker != nullptr) {
+      tracker->reset(vert, horz);
+    }
+    return *this;
+  }
+
+  // stateString() returns the player to move, a colon, and a character for
+  // each cell, in order: 'X' or 'O' if it is owned, and '-' if it is empty.
+  // reverseStateString() is the same, but with the cells in reverse order,
+  // which is the stateString() of the board rotated by 180 degrees.
+  std::string stateString() const {
+    std::string result(stateLength, '-');
+    formatState(&result[0]);
+    return result;
+  }
+
+  std::string reverseStateString() const {
+    std::string result(stateLength, '-');
+    formatReverseState(&result[0]);
+    return result;
+  }
+
+  // The length of a stateString().
+  static constexpr size_t stateLength = count + 2;
+
+  // formatState(out) writes the stateLength characters of stateString() to
+  // out, and returns stateLength. It does not write a terminating NUL.
+  size_t formatState(char *out) const {
+    out[0] = play;
+    out[1] = ':';
+    std::fill(out + 2, out + stateLength, '-');
+    for (bitpos i : horz) {
+      out[2 + i] = 'O';
+    }
+    for (bitpos i : vert) {
+      out[2 + i] = 'X';
+    }
+    return stateLength;
+  }
+
+  // formatReverseState(out) writes reverseStateString() as formatState()
+  // writes stateString().
+  size_t formatReverseState(char *out) const {
+    out[0] = play;
+    out[1] = ':';
+    std::fill(out + 2, out + stateLength, '-');
+    for (bitpos i : horz) {
+      out[2 + max - i] = 'O';
+    }
+    for (bitpos i : vert) {
+      out[2 + max - i] = 'X';
+    }
+    return stateLength;
+  }
+
+  // Two boards are equal if they have the same cells owned by each player and
+  // the same player to move. operator< is a total order consistent with that
+  // (vertical cells first, then horizontal cells, then the player to move),
+  // so Boards can be sorted and used as std::map keys.
+  bool operator==(const Board &other) const {
+    return play == other.play && vert == other.vert && horz == other.horz;
+  }
+
+  bool operator!=(const Board &other) const {
+    return !this->operator==(other);
+  }
+
+  bool operator<(const Board &other) const {
+    if (vert != other.vert) {
+      return vert < other.vert;
+    }
+    if (horz != other.horz) {
+      return horz < other.horz;
+    }
+    return play < other.play;
+  }
+
+  // Returns the 64-bit Zobrist hash of the board state (see ZobristKeys),
+  // which go() and the other mutators keep up to date, so this costs nothing.
+  // Equal boards have equal hashes.
+  uint64_t hash() const { return key; }
+
+  // transform(cells, s) returns the cells to which symmetry s moves the given
+  // cells, for example to map the cells of a result about canonical() back to
+  // this board.
+  static cellSet transform(cellSet cells, Symmetry s) {
+    switch (s) {
+    case ROTATE180:
+      return cells.rotate180();
+    case TRANSPOSE:
+      return cells.transpose();
+    case ANTI_TRANSPOSE:
+      return cells.anti_transpose();
+    default:
+      return cells;
+    }
+  }
+
+  // transformed(s) returns the board that symmetry s makes of this one, with
+  // the players exchanged if swapsPlayers(s). It is not tracked.
+  Board<N> transformed(Symmetry s) const {
+    if (swapsPlayers(s)) {
+      return Board<N>(transform(horz, s), transform(vert, s), opponent());
+    }
+    return Board<N>(transform(vert, s), transform(horz, s), play);
+  }
+
+  // canonical(applied) returns the least board (by operator<) among this
+  // board and the other three that the symmetries make of it, so boards that
+  // differ only by a symmetry have the same canonical board. If applied is
+  // not null, it is set to the symmetry s for which canonical() is
+  // transformed(s); since s is its own inverse, transform(cells, s) maps
+  // cells of the canonical board back to this one.
+  //
+  // Note that if swapsPlayers(s), the canonical board's X is this board's O:
+  // a result such as "X to move wins" about the canonical board is "O to move
+  // wins" about this one.
+  Board<N> canonical(Symmetry *applied = nullptr) const {
+    Symmetry best = IDENTITY;
+    cellSet bestVert = vert, bestHorz = horz;
+    char bestPlay = play;
+    // Compare the transformed cells before making a Board, which would hash
+    // them.
+    for (Symmetry s : {ROTATE180, TRANSPOSE, ANTI_TRANSPOSE}) {
+      const bool swap = swapsPlayers(s);
+      const cellSet v = transform(swap ? horz : vert, s);
+      const cellSet h = transform(swap ? vert : horz, s);
+      const char p = swap ? opponent() : play;
+      if (v != bestVert ? v < bestVert :
+          h != bestHorz ? h < bestHorz : p < bestPlay) {
+        best = s;
+        bestVert = v;
+        bestHorz = h;
+        bestPlay = p;
+      }
+    }
+    if (applied != nullptr) {
+      *applied = best;
+    }
+    if (best == IDENTITY) {
+      return *this;
+    }
+    return Board<N>(bestVert, bestHorz, bestPlay);
+  }
+
+  // Returns canonical().hash(), a key under which to cache a result for
+  // every board that is symmetric to this one.
+  uint64_t canonicalHash(Symmetry *applied = nullptr) const {
+    return canonical(applied).hash();
+  }
+
+  // Returns the Zobrist hash computed from scratch, from every owned cell and
+  // the player to move. It always equals hash(); tests use it to check that.
+  //
+  // It visits the cells a word at a time, with two independent chains of
+  // xors, rather than through the cellset iterator; this is most of the cost
+  // of parsing a board (see parse()).
+  uint64_t computeHash() const {
+    uint64_t x = play == 'O' ? zobristKeys.horizontalToMove : 0, o = 0;
+    for (bitpos q = 0; q < (count + 63) / 64; ++q) {
+      const uint64_t *xKeys = zobristKeys.cell[0] + 64*q;
+      const uint64_t *oKeys = zobristKeys.cell[1] + 64*q;
+      for (uint64_t w = vert.word(q); w != 0; w &= w - 1) {
+        x ^= xKeys[lowestBitPosition(w)];
+      }
+      for (uint64_t w = horz.word(q); w != 0; w &= w - 1) {
+        o ^= oKeys[lowestBitPosition(w)];
+      }
+    }
+    return x ^ o;
+  }
+
+  // The number of words in a packed record of a board (see pack()).
+  static constexpr int recordWords = 2*((count + 63) / 64) + (count % 64 == 0);
+
+  // pack(record) writes the board to the recordWords words at record, as a
+  // fixed-width binary record: the words of verticalCells() (see
+  // qset.word()), then the words of horizontalCells(), with the player to
+  // move in one bit. If count is not a multiple of 64, that is the unused
+  // high bit of the last word, which is set if O is to move; otherwise it is
+  // bit 0 of an extra word. The words are in the byte order of the machine.
+  //
+  // A 13×13 record is 48 bytes, where its stateString() is 171 characters.
+  void pack(uint64_t *record) const {
+    constexpr bitpos QUADWORDS = (count + 63) / 64;
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      record[q] = vert.word(q);
+      record[QUADWORDS + q] = horz.word(q);
+    }
+    const uint64_t horizontalToMove = play == 'O';
+    if (count % 64 == 0) {
+      record[2*QUADWORDS] = horizontalToMove;
+    } else {
+      record[2*QUADWORDS - 1] |= horizontalToMove << 63;
+    }
+  }
+
+  // unpack(record) returns the board that pack() wrote to record. Panics if
+  // the record has bits set outside the board, or a cell owned by both
+  // players.
+  static Board<N> unpack(const uint64_t *record) {
+    constexpr bitpos QUADWORDS = (count + 63) / 64;
+    const uint64_t horizontalToMove = count % 64 == 0 ?
+        record[2*QUADWORDS] : record[2*QUADWORDS - 1] >> 63;
+    uint64_t stray = count % 64 == 0 ? horizontalToMove & ~1ULL : 0;
+    cellSet v, h;
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      const uint64_t valid = allCells().word(q);
+      uint64_t hw = record[QUADWORDS + q];
+      if (q == QUADWORDS - 1 && count % 64 != 0) {
+        hw &= ~(1ULL << 63);
+      }
+      v.set_word(q, record[q] & valid);
+      h.set_word(q, hw & valid);
+      stray |= (record[q] | hw) & ~valid;
+    }
+    if (stray != 0) {
+      panic("Board.unpack(): the record has bits outside a %d×%d board",
+          int(N), int(N));
+    }
+    return Board<N>(v, h, horizontalToMove ? 'O' : 'X');
+  }
 
   // MappedRender writes to w a textual representation of a game board,
   // including column and row labels. The map argument associates chars with
@@ -180,6 +576,15 @@ public:
   }
 
 private:
+  // Panics if hash() is not computeHash(). go() and undo() call this when
+  // BOARD_VERIFY_HASH is defined, as it is for the tests.
+  void verifyHash(const char *where) const {
+    if (key != computeHash()) {
+      panic("%s: hash is %016llx; should be %016llx", where,
+          (unsigned long long)key, (unsigned long long)computeHash());
+    }
+  }
+
   bool verticalHasWon() const;
   bool horizontalHasWon() const;
   static bool isConnected(cellset<N> start, cellset<N> owned, cellset<N> stop);
@@ -188,12 +593,14 @@ private:
   static bool isVirtuallyConnected(
       cellset<N> start, cellset<N> owned, cellset<N> stop, cellset<N> vacant);
 
-  static_assert (N >= 1 && N <= 13, "Board size must be in 1..13");
+  static_assert (N >= 1 && N <= 19, "Board size must be in 1..19");
 };
 
 template<bitpos N> const int Board<N>::size; // Edge length of the board.
 template<bitpos N> const int Board<N>::max; // Cell numbers run from 0 to max.
 template<bitpos N> const int Board<N>::count; // Count of cells on the board.
+template<bitpos N> const size_t Board<N>::stateLength; // See stateString().
+template<bitpos N> const int Board<N>::recordWords; // See pack().
 
 // Writes to w a formatted view of a game board, including column and row
 // labels. Cells owned by the vertical player are indicated by an X, those
@@ -209,88 +616,114 @@ std::ostream& operator<< (std::ostream &w, const Board<N> &board) {
   return board.Render(w);
 }
 
+namespace std {
 template<bitpos N>
-Board<N>::Board(std::string content) {
-  vert = cellSet{0};
-  horz = cellSet{0};
-  content.erase(
-    std::remove_if(content.begin(), content.end(), 
-      [](char ch) { return std::isspace<char>(ch, std::locale::classic()); }),
-    content.end());
-
-  if (content.size() != N*N) {
-    panic("Board(content): content.size() is %lu; want N×N (%d)",
-        content.size(), N*N);
-  }
-
-  int x = 0, o = 0, i = -1;
-  for (char c : content) {
-    i++;
-    switch (c) {
-    case 'X':
-      // X's goal is to connect the top edge to the bottom edge (vertical).
-      x++;
-      // std::cout << "Adding cell " << i << " to vert " << std::endl
-      //           << "  was: " << this->vert << std::endl;
-      this->vert.set(i);
-      // std::cout << "  now: " << this->vert << std::endl;
-      break;
-    case 'O':
-      o++;
-      // O's goal is to connect the left edge to the right edge (horizontal).
-      // std::cout << "Adding cell " << i << " to horz " << std::endl
-      //           << "  was: " << this->horz << std::endl;
-      this->horz.set(i);
-      // std::cout << "  now: " << this->horz << std::endl;
-      break;
-    case '.':
-    case '-':
-    case '\xb7':
-      // These characters represent empty cells (U+00B7 is MIDDLE DOT).
-      break;
-    default:
-      panic("Board(state): state string may only contain "
-        "whitespace, 'X', 'O', '.', '-', and '·' (middle-dot) characters");
-    }
+struct hash< Board<N> > {
+  inline size_t operator()(const Board<N> &board) const {
+    return size_t(board.hash());
   }
-  this->play = x > o ? 'O' : 'X';
+};
 }
 
+// Returns the board owning the cells of the count cell characters at text,
+// with the player to move given by the counts of cells, as for
+// Board(content). Panics if a character is not a cell character.
+template<bitpos N>
+static Board<N> boardFromCells(const char *text) {
+  constexpr bitpos QUADWORDS = (N*N + 63) / 64;
+  uint64_t x[QUADWORDS], o[QUADWORDS];
+  if (!classifyCells(text, N*N, x, o)) {
+    panic("Board(state): state string may only contain "
+      "whitespace, 'X', 'O', '.', '-', and '·' (middle-dot) characters");
+  }
+  cellset<N> vert, horz;
+  for (bitpos q = 0; q < QUADWORDS; ++q) {
+    vert.set_word(q, x[q]);
+    horz.set_word(q, o[q]);
+  }
+  // X's goal is to connect the top edge to the bottom edge (vertical), and
+  // O's goal is to connect the left edge to the right edge (horizontal).
+  return Board<N>(vert, horz, vert.count() > horz.count() ? 'O' : 'X');
+}
+
+template<bitpos N>
+Board<N> Board<N>::parse(const char *text, size_t length) {
+  if (length == size_t(count)) {
+    return boardFromCells<N>(text);
+  }
+  // Copy the cell characters out from among the whitespace.
+  char cells[count];
+  size_t n = 0;
+  for (size_t i = 0; i < length; ++i) {
+    const char c = text[i];
+    if (!isBoardSpace(c)) {
+      if (n == size_t(count)) {
+        n = count + 1;
+        break;
+      }
+      cells[n++] = c;
+    }
+  }
+  if (n != size_t(count)) {
+    panic("Board(content): content has %s cells; want N×N (%d)",
+        n > size_t(count) ? "more than N×N" : std::to_string(n).c_str(),
+        count);
+  }
+  return boardFromCells<N>(cells);
+}
 
 template<bitpos N>
-std::string Board<N>::stateString() const {
-  std::ostringstream stream;
-  stream << play << ':';
-  for (int i=0; i < count; ++i) {
-    stream << (vert.test(i) ? 'X' : horz.test(i) ? 'O' : '-');
+Board<N> Board<N>::parseState(const char *text, size_t length) {
+  if (length != stateLength || (text[0] != 'X' && text[0] != 'O') ||
+      text[1] != ':') {
+    panic("Board.parseState(): \"%.*s\" is not a %d×%d state string",
+        int(std::min(length, stateLength + 8)), text, int(N), int(N));
   }
-  return stream.str();
+  Board<N> result = boardFromCells<N>(text + 2);
+  result.setPlayer(text[0]);
+  return result;
 }
 
 template<bitpos N>
-std::string Board<N>::reverseStateString() const {
-  std::ostringstream stream;
-  stream << play << ':';
-  for (int i=count-1; i >= 0; --i) {
-    stream << (vert.test(i) ? 'X' : horz.test(i) ? 'O' : '-');
+size_t Board<N>::parseStates(const char *text, size_t length, Board<N> *out) {
+  size_t boards = 0;
+  int line = 0;
+  for (const char *end = text + length; text < end; ) {
+    ++line;
+    const char *eol = std::find(text, end, '\n');
+    size_t n = eol - text;
+    if (n > 0 && text[n - 1] == '\r') {
+      --n;
+    }
+    if (n > 0) {
+      try {
+        out[boards] = parseState(text, n);
+      } catch (const Panic &p) {
+        panic("Board.parseStates(): line %d: %s", line, p.what());
+      }
+      ++boards;
+    }
+    text = eol + (eol < end);
   }
-  return stream.str();
+  return boards;
 }
 
-// displayChar decides what character should be printed to represent the state
-// of the indicated cell. `show` is a map from rune to bitset, and each
+// displayChars decides what character should be printed to represent the
+// state of each cell. `show` is a map from rune to bitset, and each
 // rune/bitset pairing indicates that the cells in the bitset should be
-// rendered using the corresponding rune. If more than one bitset contains the
-// target cell, one is chosen in an implementation-dependent way. If none of
-// the bitsets includes the cell, returns '-'.
+// rendered using the corresponding rune. If more than one bitset contains a
+// cell, one is chosen in an implementation-dependent way. If none of the
+// bitsets includes a cell, it is rendered as '-'.
 template<bitpos N>
-static char displayChar(int cell, const PrintMap<N>& show) {
-  for (auto kv : show) {
-    if (kv.second.test(cell)) {
-      return kv.first;
+static std::string displayChars(const PrintMap<N>& show) {
+  std::string result(N*N, '-');
+  // Visit the map in reverse, so that the first bitset containing a cell wins.
+  for (auto kv = show.rbegin(); kv != show.rend(); ++kv) {
+    for (bitpos cell : kv->second) {
+      result[cell] = kv->first;
     }
   }
-  return '-';
+  return result;
 }
 
 
@@ -305,6 +738,7 @@ std::ostream& Board<N>::MappedRender(std::ostream& w, std::string indent, const
   w  << std::endl;
 
   // Print board lines, prefixing each with its row number.
+  const std::string chars = displayChars<N>(show);
   int cellIndex = 0;
   for (int row=0; row < N; row++) {
     if (row != 0 && row+1 != 10) {
@@ -312,7 +746,7 @@ std::ostream& Board<N>::MappedRender(std::ostream& w, std::string indent, const
     }
     w << indent << row+1 << ": ";
     for (int col=0; col < N; col++) {
-      char ch = displayChar<N>(cellIndex, show);
+      char ch = chars[cellIndex];
       cellIndex++;
       if (col != 0) {
         w << ' ';
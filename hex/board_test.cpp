@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <random>
 #include <sstream>
+#include <unordered_set>
 #include "board.h"
+#include "randomgame.h"
 #include "gtest/gtest.h"
 
 
@@ -26,6 +30,20 @@ TEST(BoardConstruction, BoardDefaultConstructor) {
   EXPECT_EQ(168, b13.max);
   EXPECT_EQ(169, b13.count);
   EXPECT_EQ('X', b13.player());
+
+  Board<16> b16;
+  EXPECT_EQ(16, b16.size);
+  EXPECT_EQ(255, b16.max);
+  EXPECT_EQ(256, b16.count);
+  EXPECT_EQ('X', b16.player());
+  EXPECT_EQ(cellset<16>::universe(), b16.emptyCells());
+
+  Board<19> b19;
+  EXPECT_EQ(19, b19.size);
+  EXPECT_EQ(360, b19.max);
+  EXPECT_EQ(361, b19.count);
+  EXPECT_EQ('X', b19.player());
+  EXPECT_EQ(cellset<19>::universe(), b19.emptyCells());
 }
 
 // Tests content constructor for Board.
@@ -122,6 +140,316 @@ TEST(BoardState, StateManagement) {
 }
 
 
+// Tests Board equality, ordering, and hashing.
+TEST(BoardState, HashAndOrder) {
+  std::vector< Board<3> > boards = {
+    Board<3>(), Board<3>().setPlayer('O'),
+    Board<3>("X--------"), Board<3>("-X-------"), Board<3>("O--------"),
+    Board<3>("XO-------"), Board<3>("OX-------").setPlayer('X'),
+    Board<3>("XO-------").setPlayer('O'), Board<3>("XXXOO----"),
+  };
+  std::unordered_set< Board<3> > distinct(boards.begin(), boards.end());
+  EXPECT_EQ(boards.size(), distinct.size());
+  for (int i = 0; i < boards.size(); ++i) {
+    EXPECT_EQ(1, distinct.count(boards[i]));
+    for (int j = 0; j < boards.size(); ++j) {
+      const Board<3> &a = boards[i], &b = boards[j];
+      EXPECT_EQ(i == j, a == b) << a << b;
+      EXPECT_EQ(i != j, a != b) << a << b;
+      EXPECT_EQ(i == j, a.hash() == b.hash()) << a << b;
+      EXPECT_EQ(i != j, (a < b) != (b < a)) << a << b;
+    }
+  }
+  std::sort(boards.begin(), boards.end());
+  for (int i = 1; i < boards.size(); ++i) {
+    EXPECT_TRUE(boards[i-1] < boards[i]);
+  }
+  EXPECT_EQ(Board<3>("X--------"), Board<3>().go(0));
+  for (auto &board : boards) {
+    EXPECT_EQ(board.computeHash(), board.hash()) << board;
+  }
+}
+
+// Plays random games, checking after every change that the Zobrist hash
+// maintained by the board matches the one computed from scratch, and that
+// boards reached by different move orders have the same hash.
+TEST(BoardState, IncrementalHash) {
+  std::minstd_rand generator;
+  for (int game = 0; game < 20; ++game) {
+    const std::vector<int> cells = randomGame<7>(generator);
+    Board<7> b;
+    EXPECT_EQ(0ULL, b.hash());
+    for (int i = 0; i < Board<7>::count; ++i) {
+      b.go(cells[i]);
+      EXPECT_EQ(b.computeHash(), b.hash());
+      if (i % 2 == 1 && i > 2) {
+        // Swapping the last two moves of each player gives the same board.
+        Board<7> other;
+        for (int j = 0; j <= i; ++j) {
+          other.go(cells[j == i ? i - 2 : j == i - 2 ? i : j]);
+        }
+        EXPECT_EQ(b, other);
+        EXPECT_EQ(b.hash(), other.hash());
+      }
+    }
+    Board<7> copy = b;
+    EXPECT_EQ(b.hash(), copy.hash());
+    copy.setPlayer(copy.opponent());
+    EXPECT_NE(b.hash(), copy.hash());
+    EXPECT_EQ(copy.computeHash(), copy.hash());
+    copy.setPlayer(b.player());
+    EXPECT_EQ(b.hash(), copy.hash());
+  }
+
+  Board<5> b("--X---O----X------O------");
+  EXPECT_EQ(b.computeHash(), b.hash());
+  b.embed(Board<2>("XO--"), 0, 0);
+  EXPECT_EQ(b.computeHash(), b.hash());
+  EXPECT_EQ(b.hash(), Board<5>(b.verticalCells(), b.horizontalCells(),
+                               b.player()).hash());
+}
+
+TEST(BoardState, SubBoard) {
+  const Board<5> b(R"(- - - - -
+                       - X O - -
+                        - X - O -
+                         O X - - -
+                          - - - - X)");
+  const Board<3> part = b.subBoard<3>(1, 1);
+  EXPECT_EQ(Board<3>("XO-X-OX--").setPlayer(b.player()), part);
+  EXPECT_EQ(Board<2>("---X").setPlayer(b.player()), b.subBoard<2>(3, 3));
+
+  Board<5> copy = b;
+  copy.embed(part, 1, 1);
+  EXPECT_EQ(b, copy);
+  copy.embed(Board<3>(), 1, 1);
+  EXPECT_EQ(Board<5>("---------------O--------X").setPlayer(b.player()),
+            copy);
+  EXPECT_THROW(b.subBoard<3>(3, 0), Panic);
+  EXPECT_THROW(Board<3>(cellset<3>::make({4}), cellset<3>::make({4}), 'X'),
+               Panic);
+}
+
+TEST(BoardState, Symmetries) {
+  const Board<3> b(R"(X O -
+                       - X -
+                        - - -)");
+  EXPECT_EQ(Board<3>("---" "-X-" "-OX").setPlayer('O'),
+            b.transformed(ROTATE180));
+  EXPECT_EQ(Board<3>("O--" "XO-" "---").setPlayer('X'),
+            b.transformed(TRANSPOSE));
+  EXPECT_EQ(Board<3>("---" "-OX" "--O").setPlayer('X'),
+            b.transformed(ANTI_TRANSPOSE));
+  EXPECT_EQ(b, b.transformed(IDENTITY));
+  EXPECT_EQ(Board<3>::cellSet::make({8, 7}),
+            Board<3>::transform(Board<3>::cellSet::make({0, 1}), ROTATE180));
+}
+
+// Checks that the boards that the symmetries make of random boards all have
+// the same canonical board and canonicalHash(), and that the reported
+// symmetry maps each board to its canonical board and back.
+TEST(BoardState, Canonical) {
+  std::minstd_rand generator;
+  std::uniform_int_distribution<int> dist(0, 2);
+  for (int round = 0; round < 100; ++round) {
+    Board<7>::cellSet vert, horz;
+    for (bitpos cell = 0; cell < Board<7>::count; ++cell) {
+      switch (dist(generator)) {
+      case 0: vert.set(cell); break;
+      case 1: horz.set(cell); break;
+      }
+    }
+    const Board<7> b(vert, horz, round % 2 ? 'X' : 'O');
+    Symmetry applied;
+    const Board<7> canon = b.canonical(&applied);
+    EXPECT_EQ(canon, b.transformed(applied));
+    EXPECT_EQ(b, canon.transformed(applied));
+    EXPECT_EQ(canon.hash(), b.canonicalHash());
+    EXPECT_EQ(canon.computeHash(), canon.hash());
+    EXPECT_FALSE(b < canon);
+    for (Symmetry s : {IDENTITY, ROTATE180, TRANSPOSE, ANTI_TRANSPOSE}) {
+      const Board<7> other = b.transformed(s);
+      EXPECT_EQ(b, other.transformed(s));
+      EXPECT_EQ(canon, other.canonical());
+      EXPECT_EQ(b.canonicalHash(), other.canonicalHash());
+      EXPECT_EQ(swapsPlayers(s) ? b.opponent() : b.player(), other.player());
+    }
+  }
+}
+
+// Checks classifyCells() against a character-at-a-time loop, for lengths on
+// either side of the 16-character blocks, with and without a bad character.
+TEST(BoardText, ClassifyCells) {
+  std::minstd_rand generator;
+  const char chars[] = {'X', 'O', '-', '.', '\xb7'};
+  for (size_t count = 0; count <= 130; ++count) {
+    std::string text;
+    for (size_t i = 0; i < count; ++i) {
+      text += chars[generator() % 5];
+    }
+    uint64_t x[3], o[3], wantX[3] = {0}, wantO[3] = {0};
+    for (size_t i = 0; i < count; ++i) {
+      wantX[i / 64] |= uint64_t(text[i] == 'X') << (i % 64);
+      wantO[i / 64] |= uint64_t(text[i] == 'O') << (i % 64);
+    }
+    ASSERT_TRUE(classifyCells(text.data(), count, x, o)) << text;
+    for (size_t q = 0; q < (count + 63) / 64; ++q) {
+      EXPECT_EQ(wantX[q], x[q]) << text;
+      EXPECT_EQ(wantO[q], o[q]) << text;
+    }
+    if (count > 0) {
+      text[generator() % count] = ' ';
+      EXPECT_FALSE(classifyCells(text.data(), count, x, o)) << text;
+    }
+  }
+}
+
+// Checks that parse(), parseState(), and parseStates() are inverses of
+// stateString() and formatState().
+template<bitpos N>
+void testParseFormat() {
+  std::minstd_rand generator(N);
+  std::string corpus;
+  std::vector< Board<N> > boards;
+  for (int round = 0; round < 20; ++round) {
+    Board<N> b;
+    for (int i = 0; i < N*N; ++i) {
+      if (generator() % 3 == 0 && !b.occupiedCells().test(i)) {
+        b.go(i);
+      }
+    }
+    const std::string state = b.stateString();
+    EXPECT_EQ(b, Board<N>::parseState(state.data(), state.size()));
+    // Moves alternate, so parse() infers the same player to move.
+    EXPECT_EQ(b, Board<N>::parse(state.data() + 2, state.size() - 2));
+    char buffer[N*N + 2];
+    ASSERT_EQ(Board<N>::stateLength, b.formatState(buffer));
+    EXPECT_EQ(state, std::string(buffer, Board<N>::stateLength));
+    ASSERT_EQ(Board<N>::stateLength, b.formatReverseState(buffer));
+    EXPECT_EQ(b.reverseStateString(), std::string(buffer, sizeof buffer));
+
+    boards.push_back(b);
+    corpus += state + (round % 3 ? "\n" : "\r\n\n");
+  }
+  corpus.pop_back();
+
+  std::vector< Board<N> > parsed(boards.size() + 20);
+  ASSERT_EQ(boards.size(),
+            Board<N>::parseStates(corpus.data(), corpus.size(), parsed.data()));
+  for (size_t i = 0; i < boards.size(); ++i) {
+    EXPECT_EQ(boards[i], parsed[i]) << N << " " << i;
+  }
+}
+
+TEST(BoardText, ParseFormat) {
+  testParseFormat<1>();
+  testParseFormat<4>();
+  testParseFormat<8>();
+  testParseFormat<11>();
+  testParseFormat<13>();
+  testParseFormat<19>();
+}
+
+TEST(BoardText, ParseErrors) {
+  const std::string good = "X:-O-" "X--" "---";
+  EXPECT_EQ(Board<3>("-O-X-----").setPlayer('X'),
+            Board<3>::parseState(good.data(), good.size()));
+  for (std::string bad : {"X-O-X-----", "?:-O-X-----", "X:-O-X----",
+                          "X:-O-X------", "X:-O-X--- -"}) {
+    EXPECT_THROW(Board<3>::parseState(bad.data(), bad.size()), Panic) << bad;
+  }
+  EXPECT_THROW(Board<3>("-O-X--?--"), Panic);
+  EXPECT_THROW(Board<3>("-O-X-- --"), Panic);
+  EXPECT_THROW(Board<3>("-O-X---- --"), Panic);
+
+  const std::string lines = good + "\n" + good + "\nX:-O-X--?-\n";
+  Board<3> out[3];
+  try {
+    Board<3>::parseStates(lines.data(), lines.size(), out);
+    FAIL() << "parseStates() did not panic";
+  } catch (const Panic &p) {
+    EXPECT_NE(std::string::npos, std::string(p.what()).find("line 3"))
+      << p.what();
+  }
+}
+
+// Checks that unpack() inverts pack(), on sizes whose records do and do
+// not need an extra word for the player to move.
+template<bitpos N>
+void testPackUnpack() {
+  std::minstd_rand generator(N);
+  uint64_t record[Board<N>::recordWords];
+  for (int round = 0; round < 20; ++round) {
+    Board<N> b;
+    for (int i = 0; i < N*N; ++i) {
+      if (generator() % 3 == 0) {
+        b.go(i);
+      }
+    }
+    b.setPlayer(round % 2 ? 'X' : 'O');
+    b.pack(record);
+    const Board<N> unpacked = Board<N>::unpack(record);
+    EXPECT_EQ(b, unpacked) << N;
+    EXPECT_EQ(b.hash(), unpacked.hash()) << N;
+  }
+}
+
+TEST(BoardState, PackUnpack) {
+  EXPECT_EQ(2, Board<1>::recordWords);
+  EXPECT_EQ(3, Board<8>::recordWords);
+  EXPECT_EQ(6, Board<13>::recordWords);
+  EXPECT_EQ(9, Board<16>::recordWords);
+  EXPECT_EQ(12, Board<19>::recordWords);
+  testPackUnpack<1>();
+  testPackUnpack<5>();
+  testPackUnpack<8>();
+  testPackUnpack<13>();
+  testPackUnpack<16>();
+  testPackUnpack<19>();
+
+  uint64_t record[Board<3>::recordWords] = {1, 1};
+  EXPECT_THROW(Board<3>::unpack(record), Panic);
+  record[1] = (1ULL << 63) | 2;
+  EXPECT_EQ(Board<3>("XO-------").setPlayer('O'),
+            Board<3>::unpack(record));
+  record[0] |= 1 << 9;
+  EXPECT_THROW(Board<3>::unpack(record), Panic);
+  uint64_t record8[Board<8>::recordWords] = {1, 2, 2};
+  EXPECT_THROW(Board<8>::unpack(record8), Panic);
+}
+
+TEST(BoardPlay, Undo) {
+  std::minstd_rand generator;
+  const std::vector<int> cells = randomGame<6>(generator);
+  Board<6> b("-------X----O-----------------------");
+  std::vector< Board<6> > history;
+  for (int at : cells) {
+    if (!b.emptyCells().test(at)) {
+      continue;
+    }
+    history.push_back(b);
+    b.go(at);
+  }
+  EXPECT_TRUE(b.emptyCells().none());
+  for (auto i = cells.rbegin(); i != cells.rend(); ++i) {
+    if (*i == 7 || *i == 12) {
+      continue;
+    }
+    b.undo(*i);
+    EXPECT_EQ(history.back(), b);
+    EXPECT_EQ(history.back().hash(), b.hash());
+    history.pop_back();
+  }
+  EXPECT_EQ(Board<6>("-------X----O-----------------------"), b);
+
+  // Only the last player's cells can be taken back.
+  Board<3> c = Board<3>().go(4).go(0);
+  EXPECT_THROW(c.undo(4), Panic);
+  EXPECT_THROW(c.undo(1), Panic);
+  EXPECT_THROW(c.undo(9), Panic);
+  EXPECT_EQ(Board<3>().go(4), c.undo(0));
+}
+
 // Tests Board stream printing.
 TEST(BoardState, BoardPrinting) {
   {
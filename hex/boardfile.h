@@ -0,0 +1,181 @@
+#ifndef __HEXBOARDFILE_H__
+#define __HEXBOARDFILE_H__ 1
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <iterator>
+#include <string>
+#include "panic.h"
+#include "board.h"
+
+// Board Files
+// ===========
+// A board file is a sequence of packed records of N×N boards (see
+// Board.pack()), each of Board<N>::recordWords words, with no header or
+// padding, so record i starts at byte i * recordBytes. The records are in the
+// byte order of the machine that wrote them. A BoardFileWriter<N> writes such
+// a file, and a BoardFile<N> maps one into memory and reads its boards
+// without copying the file.
+
+// BoardFile<N> maps a board file read-only. Its boards are unpacked from the
+// mapped records as they are read, so iterating over a large file touches
+// each page once and makes no copy of it.
+template<bitpos N>
+class BoardFile {
+public:
+  static constexpr size_t recordBytes =
+      Board<N>::recordWords * sizeof(uint64_t);
+
+  // BoardFile(path) maps the board file at path. Panics if it cannot be
+  // opened or mapped, or if its size is not a multiple of recordBytes.
+  explicit BoardFile(const std::string &path) : words(nullptr), length(0) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      panic("BoardFile(%s): %s", path.c_str(), strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      const int err = errno;
+      close(fd);
+      panic("BoardFile(%s): %s", path.c_str(), strerror(err));
+    }
+    const size_t bytes = st.st_size;
+    if (bytes % recordBytes != 0) {
+      close(fd);
+      panic("BoardFile(%s): size %zu is not a multiple of %zu-byte records",
+          path.c_str(), bytes, recordBytes);
+    }
+    if (bytes > 0) {
+      void *map = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+      if (map == MAP_FAILED) {
+        const int err = errno;
+        close(fd);
+        panic("BoardFile(%s): %s", path.c_str(), strerror(err));
+      }
+      words = static_cast<const uint64_t *>(map);
+      length = bytes / recordBytes;
+    }
+    close(fd);
+  }
+
+  ~BoardFile() {
+    if (words != nullptr) {
+      munmap(const_cast<uint64_t *>(words), length * recordBytes);
+    }
+  }
+
+  BoardFile(const BoardFile &) = delete;
+  BoardFile &operator=(const BoardFile &) = delete;
+
+  // Returns the number of boards in the file.
+  size_t size() const { return length; }
+
+  // Returns the packed record of board i.
+  const uint64_t *record(size_t i) const {
+    return words + i * Board<N>::recordWords;
+  }
+
+  // Returns board i. Panics if its record is not a valid board.
+  Board<N> operator[](size_t i) const { return Board<N>::unpack(record(i)); }
+
+  // iterator is an input iterator over the boards of the file, in order.
+  // (operator* unpacks each board and returns it by value, which a forward
+  // iterator may not do.)
+  class iterator {
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef Board<N> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Board<N>* pointer;
+    typedef Board<N> reference;
+
+    explicit iterator(const uint64_t *at) : at(at) { }
+    Board<N> operator*() const { return Board<N>::unpack(at); }
+    iterator &operator++() {
+      at += Board<N>::recordWords;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator result = *this;
+      ++*this;
+      return result;
+    }
+    bool operator==(const iterator &other) const { return at == other.at; }
+    bool operator!=(const iterator &other) const { return at != other.at; }
+
+  private:
+    const uint64_t *at;
+  };
+
+  iterator begin() const { return iterator(record(0)); }
+  iterator end() const { return iterator(record(length)); }
+
+private:
+  const uint64_t *words; // The mapped file, or null if it is empty.
+  size_t length; // The number of records.
+};
+
+template<bitpos N> const size_t BoardFile<N>::recordBytes;
+
+// BoardFileWriter<N> writes a board file, through a stdio buffer.
+template<bitpos N>
+class BoardFileWriter {
+public:
+  // BoardFileWriter(path) creates, or truncates, the file at path. Panics if
+  // it cannot.
+  explicit BoardFileWriter(const std::string &path)
+      : name(path), file(fopen(path.c_str(), "wb")) {
+    if (file == nullptr) {
+      panic("BoardFileWriter(%s): %s", path.c_str(), strerror(errno));
+    }
+  }
+
+  // Closes the file, if close() has not, ignoring any error.
+  ~BoardFileWriter() {
+    if (file != nullptr) {
+      fclose(file);
+    }
+  }
+
+  BoardFileWriter(const BoardFileWriter &) = delete;
+  BoardFileWriter &operator=(const BoardFileWriter &) = delete;
+
+  // write(b) appends the record of b. Panics if it cannot.
+  BoardFileWriter<N>& write(const Board<N> &b) {
+    return write(&b, 1);
+  }
+
+  // write(boards, n) appends the records of the n boards at boards.
+  BoardFileWriter<N>& write(const Board<N> *boards, size_t n) {
+    uint64_t record[Board<N>::recordWords];
+    for (size_t i = 0; i < n; ++i) {
+      boards[i].pack(record);
+      if (fwrite(record, sizeof record, 1, file) != 1) {
+        panic("BoardFileWriter(%s).write(): %s", name.c_str(),
+            strerror(errno));
+      }
+    }
+    return *this;
+  }
+
+  // close() flushes and closes the file. Panics if that fails.
+  void close() {
+    FILE *f = file;
+    file = nullptr;
+    if (f != nullptr && fclose(f) != 0) {
+      panic("BoardFileWriter(%s).close(): %s", name.c_str(), strerror(errno));
+    }
+  }
+
+private:
+  std::string name;
+  FILE *file;
+};
+
+#endif /* __HEXBOARDFILE_H__ */
@@ -0,0 +1,82 @@
+#include <random>
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+#include "boardfile.h"
+#include "gtest/gtest.h"
+
+
+// TEST has two parameters: the test case name and the test name.
+// The test case name and the test name should both be valid C++
+// identifiers.  And you should not use underscore (_) in the names.
+
+// Returns a path for a scratch file.
+std::string scratchPath(const char *name) {
+  return std::string(P_tmpdir) + "/boardfile_test." +
+      std::to_string(getpid()) + "." + name;
+}
+
+template<bitpos N>
+void testWriteRead() {
+  std::minstd_rand generator(N);
+  std::vector< Board<N> > boards;
+  for (int round = 0; round < 100; ++round) {
+    Board<N> b;
+    for (int i = 0; i < N*N; ++i) {
+      if (generator() % 3 == 0) {
+        b.go(i);
+      }
+    }
+    boards.push_back(b);
+  }
+
+  const std::string path = scratchPath("records");
+  BoardFileWriter<N> writer(path);
+  writer.write(boards[0]).write(boards.data() + 1, boards.size() - 1);
+  writer.close();
+
+  {
+    BoardFile<N> file(path);
+    ASSERT_EQ(boards.size(), file.size()) << N;
+    size_t i = 0;
+    for (Board<N> b : file) {
+      EXPECT_EQ(boards[i], b) << N << " " << i;
+      ++i;
+    }
+    EXPECT_EQ(boards.size(), i);
+    EXPECT_EQ(boards[42], file[42]);
+  }
+  unlink(path.c_str());
+}
+
+TEST(BoardFile, WriteRead) {
+  testWriteRead<1>();
+  testWriteRead<8>();
+  testWriteRead<11>();
+  testWriteRead<13>();
+  testWriteRead<19>();
+}
+
+TEST(BoardFile, Errors) {
+  const std::string path = scratchPath("errors");
+  EXPECT_THROW(BoardFile<5>{path}, Panic);
+
+  BoardFileWriter<5>(path).write(Board<5>());
+  {
+    BoardFile<5> file(path);
+    EXPECT_EQ(1u, file.size());
+    EXPECT_EQ(Board<5>(), file[0]);
+    EXPECT_THROW(BoardFile<11>{path}, Panic); // 16 bytes, not 32.
+  }
+
+  BoardFileWriter<5> empty(path);
+  empty.close();
+  {
+    BoardFile<5> file(path);
+    EXPECT_EQ(0u, file.size());
+    EXPECT_TRUE(file.begin() == file.end());
+  }
+  unlink(path.c_str());
+
+  EXPECT_THROW(BoardFileWriter<5>("/nonexistent/directory/file"), Panic);
+}
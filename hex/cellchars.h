@@ -0,0 +1,78 @@
+#ifndef __HEXCELLCHARS_H__
+#define __HEXCELLCHARS_H__ 1
+#include <stddef.h>
+#include <stdint.h>
+
+// Classifying the characters of a board state string.
+// ===================================================
+// In the text form of a board (see Board(content) and Board.stateString()),
+// each cell is one character: 'X' or 'O' for a cell owned by the vertical or
+// horizontal player, and '-', '.', or '\xb7' (the last byte of a UTF-8
+// middle dot) for an empty cell. classifyCells() turns a run of such
+// characters into bitmasks, one bit per cell.
+//
+// If the compiler targets SSE2 (as it always does for x86-64), unless
+// BOARD_NO_SSE2 is defined, classifyCells() compares 16 characters at a time
+// with each of the five cell characters, and gathers the results into 16-bit
+// masks with PMOVMSKB. Otherwise, and for the last few characters, it looks
+// at one character at a time.
+#if defined(__SSE2__) && !defined(BOARD_NO_SSE2)
+#define BOARD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Returns whether c is one of the characters that represent a cell.
+inline bool isCellChar(char c) {
+  return c == 'X' || c == 'O' || c == '-' || c == '.' || c == '\xb7';
+}
+
+// Returns whether c is whitespace in the classic locale.
+inline bool isBoardSpace(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// classifyCells(text, count, x, o) sets bit i % 64 of x[i / 64] if text[i] is
+// 'X', and bit i % 64 of o[i / 64] if text[i] is 'O', for i from 0 to
+// count-1, and clears the other bits of the (count + 63) / 64 words of x and
+// o. Returns false, leaving x and o undefined, if any of the count characters
+// is not a cell character.
+inline bool classifyCells(const char *text, size_t count,
+                          uint64_t *x, uint64_t *o) {
+  for (size_t q = 0; q < (count + 63) / 64; ++q) {
+    x[q] = o[q] = 0;
+  }
+  size_t i = 0;
+#ifdef BOARD_SSE2
+  const __m128i xs = _mm_set1_epi8('X');
+  const __m128i os = _mm_set1_epi8('O');
+  const __m128i dashes = _mm_set1_epi8('-');
+  const __m128i dots = _mm_set1_epi8('.');
+  const __m128i middleDots = _mm_set1_epi8('\xb7');
+  for (; i + 16 <= count; i += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)(text + i));
+    const __m128i isX = _mm_cmpeq_epi8(v, xs);
+    const __m128i isO = _mm_cmpeq_epi8(v, os);
+    const __m128i isEmpty = _mm_or_si128(_mm_cmpeq_epi8(v, dashes),
+        _mm_or_si128(_mm_cmpeq_epi8(v, dots), _mm_cmpeq_epi8(v, middleDots)));
+    const int valid = _mm_movemask_epi8(
+        _mm_or_si128(_mm_or_si128(isX, isO), isEmpty));
+    if (valid != 0xFFFF) {
+      return false;
+    }
+    // i is a multiple of 16, so the 16 bits fall within one word.
+    x[i / 64] |= uint64_t(_mm_movemask_epi8(isX)) << (i % 64);
+    o[i / 64] |= uint64_t(_mm_movemask_epi8(isO)) << (i % 64);
+  }
+#endif
+  for (; i < count; ++i) {
+    const char c = text[i];
+    if (!isCellChar(c)) {
+      return false;
+    }
+    x[i / 64] |= uint64_t(c == 'X') << (i % 64);
+    o[i / 64] |= uint64_t(c == 'O') << (i % 64);
+  }
+  return true;
+}
+
+#endif /* __HEXCELLCHARS_H__ */
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <stdint.h>
 #include <initializer_list>
+#include <type_traits>
 #include "../quadset/quadset.h"
 
 // SIZE is the edge length of the board.
@@ -72,6 +73,14 @@ public:
     return this->quadSet::operator!=(other);
   }
 
+  inline constexpr bool operator<(cellSet other) const {
+    return this->quadSet::operator<(other);
+  }
+
+  inline constexpr uint64_t hash() const {
+    return this->quadSet::hash();
+  }
+
   inline constexpr bool test(bitpos pos) const {
     return this->quadSet::test(pos);
   }
@@ -80,6 +89,54 @@ public:
     return this->quadSet::to_ullong();
   }
 
+  inline constexpr bool intersects(cellSet other) const {
+    return this->quadSet::intersects(other);
+  }
+
+  inline constexpr bool is_subset_of(cellSet other) const {
+    return this->quadSet::is_subset_of(other);
+  }
+
+  inline constexpr bool any_andnot(cellSet other) const {
+    return this->quadSet::any_andnot(other);
+  }
+
+  inline bitpos count_and(cellSet other) const {
+    return this->quadSet::count_and(other);
+  }
+
+  inline bool count_at_least(bitpos k) const {
+    return this->quadSet::count_at_least(k);
+  }
+
+  inline bool union_changed(cellSet other) {
+    return this->quadSet::union_changed(other);
+  }
+
+  inline cellSet next_combination() const {
+    return cellSet{ this->quadSet::next_combination() };
+  }
+
+  inline cellSet next_submask(cellSet mask) const {
+    return cellSet{ this->quadSet::next_submask(mask) };
+  }
+
+  inline bitpos select(bitpos k) const {
+    return this->quadSet::select(k);
+  }
+
+  inline bitpos rank(bitpos pos) const {
+    return this->quadSet::rank(pos);
+  }
+
+  inline cellSet compress(cellSet mask) const {
+    return cellSet{ this->quadSet::compress(mask) };
+  }
+
+  inline cellSet expand(cellSet mask) const {
+    return cellSet{ this->quadSet::expand(mask) };
+  }
+
   inline constexpr cellSet operator<<(bitpos n) const {
     return cellSet{ this->quadSet::operator<<(n) };
   }
@@ -88,6 +145,37 @@ public:
     return cellSet{ this->quadSet::fast_lsh(n) };
   }
 
+  inline cellSet branchless_lsh(bitpos n) const {
+    return cellSet{ this->quadSet::branchless_lsh(n) };
+  }
+
+  inline cellSet fast_branchless_lsh(bitpos n) const {
+    return cellSet{ this->quadSet::fast_branchless_lsh(n) };
+  }
+
+  inline cellSet branchless_rsh(bitpos n) const {
+    return cellSet{ this->quadSet::branchless_rsh(n) };
+  }
+
+  template<bitpos n>
+  inline constexpr cellSet shl() const {
+    return cellSet{ this->quadSet::template shl<n>() };
+  }
+
+  template<bitpos n>
+  inline constexpr cellSet fast_shl() const {
+    return cellSet{ this->quadSet::template fast_shl<n>() };
+  }
+
+  template<bitpos n>
+  inline constexpr cellSet shr() const {
+    return cellSet{ this->quadSet::template shr<n>() };
+  }
+
+  inline constexpr cellSet reverse() const {
+    return cellSet{ this->quadSet::reverse() };
+  }
+
   inline constexpr cellSet operator>>(bitpos n) const {
     return cellSet{ this->quadSet::operator>>(n) };
   }
@@ -229,34 +317,155 @@ public:
     return cellSet{ quadSet::repeat_block(quadSet{1<<(SIZE-1)}, SIZE, SIZE) };
   }
 
+  // The shifts below have constant distances, so they use shl<n>() and
+  // shr<n>(), which compile to straight-line word operations.
   constexpr cellSet neighbors() const {
     constexpr auto l = ~left();
     constexpr auto r = ~right();
-    auto s = *this;
-    return ( (s >> SIZE)
-           | (((s >> (SIZE - 1)) | (s << 1)) & l)
-           | (((s << (SIZE - 1)) | (s >> 1)) & r)
-           | (s << SIZE)
+    return ( shr<SIZE>()
+           | ((shr<SIZE - 1>() | shl<1>()) & l)
+           | ((shl<SIZE - 1>() | shr<1>()) & r)
+           | shl<SIZE>()
            );
   }
 
   constexpr cellSet fast_neighbors() const {
     constexpr auto l = left().fast_not();
     constexpr auto r = right().fast_not();
-    auto s = *this;
-    return ( (s >> SIZE)
-           | (((s >> (SIZE - 1)) | s.fast_lsh(1)) & l)
-           | ((s.fast_lsh(SIZE - 1) | (s >> 1)) & r)
-           | s.fast_lsh(SIZE)
+    return ( shr<SIZE>()
+           | ((shr<SIZE - 1>() | fast_shl<1>()) & l)
+           | ((fast_shl<SIZE - 1>() | shr<1>()) & r)
+           | fast_shl<SIZE>()
            );
   }
 
+  // The symmetries of the board. Each maps neighbors to neighbors, so it maps
+  // a winning chain to a winning chain. Cell (row, col) moves to:
+  //   rotate180():      (SIZE-1-row, SIZE-1-col)
+  //   transpose():      (col, row), which exchanges the top and bottom edges
+  //                     with the left and right edges
+  //   anti_transpose(): (SIZE-1-col, SIZE-1-row)
+  // Rotating the board reverses the order of its cells, so rotate180() is a
+  // bit reversal. The transposes exchange the cells on either side of a
+  // diagonal with one delta swap per diagonal: since the rows of a cellset
+  // are SIZE bits apart, rather than a power of two, the recursive block
+  // transpose used for 8x8 bit matrices does not apply.
+  constexpr cellSet rotate180() const {
+    return reverse();
+  }
+
+  constexpr cellSet transpose() const {
+    return swap_diagonals<1, SIZE - 1>(
+      std::integral_constant<bool, (1 < SIZE)>());
+  }
+
+  constexpr cellSet anti_transpose() const {
+    return swap_diagonals<1, SIZE + 1>(
+      std::integral_constant<bool, (1 < SIZE)>());
+  }
+
+  // rectangle(row, col, rows, cols) returns the cells of the window with
+  // (row, col) as its top left cell and the given numbers of rows and
+  // columns. Panics unless the window is within the board.
+  static inline cellSet rectangle(
+      bitpos row, bitpos col, bitpos rows, bitpos cols) {
+    if (row < 0 || col < 0 || rows < 0 || cols < 0 ||
+        row + rows > SIZE || col + cols > SIZE) {
+      panic("cellset<%d>.rectangle(%d, %d, %d, %d): outside the board",
+          int(SIZE), int(row), int(col), int(rows), int(cols));
+    }
+    return cellSet{
+      quadSet::repeat_block(quadSet::range(0, cols), SIZE, rows)
+    } << (row*SIZE + col);
+  }
+
+  // crop<K>(row, col, rows, cols) returns the cells of the set in the window
+  // rectangle(row, col, rows, cols), moved to the top left corner of a K×K
+  // board. By default the window is K×K. It gathers the window's cells with
+  // compress(), which uses PEXT when BMI2 is available, and then spreads the
+  // rows out to K cells apart with expand() if the window is narrower than K.
+  // Panics unless the window fits on both boards.
+  template<bitpos K>
+  cellset<K> crop(bitpos row, bitpos col, bitpos rows = K, bitpos cols = K)
+      const {
+    static_assert(K <= SIZE, "cellset<SIZE>.crop<K>(): K must be <= SIZE");
+    if (rows > K || cols > K) {
+      panic("cellset<%d>.crop<%d>(): a %dx%d window does not fit",
+          int(SIZE), int(K), int(rows), int(cols));
+    }
+    const cellSet dense = this->compress(rectangle(row, col, rows, cols));
+    cellset<K> result;
+    for (bitpos i = 0; i < (K*K + 63) / 64; ++i) {
+      result.set_word(i, dense.word(i));
+    }
+    return cols == K ? result
+                     : result.expand(cellset<K>::rectangle(0, 0, rows, cols));
+  }
+
+  // embed(part, row, col, rows, cols) is the inverse of crop<K>: it returns
+  // the cells of the top left rows×cols corner of part, moved to the window
+  // rectangle(row, col, rows, cols) of this board size.
+  template<bitpos K>
+  static cellSet embed(cellset<K> part, bitpos row, bitpos col,
+                       bitpos rows = K, bitpos cols = K) {
+    static_assert(K <= SIZE, "cellset<SIZE>::embed(): K must be <= SIZE");
+    if (rows > K || cols > K) {
+      panic("cellset<%d>::embed(cellset<%d>): a %dx%d window does not fit",
+          int(SIZE), int(K), int(rows), int(cols));
+    }
+    if (cols != K) {
+      part = part.compress(cellset<K>::rectangle(0, 0, rows, cols));
+    }
+    cellSet dense;
+    for (bitpos i = 0; i < (K*K + 63) / 64; ++i) {
+      dense.set_word(i, part.word(i));
+    }
+    return dense.expand(rectangle(row, col, rows, cols));
+  }
+
   std::ostream& print(std::ostream &out) {
     return quadSet::print(out);
   }
   std::ostream& emit(std::ostream &out) {
     return quadSet::print(out);
   }
+
+private:
+  // Returns the cells at distance k from the main diagonal, on the side where
+  // col > row if step is SIZE - 1, or on the side of the anti-diagonal where
+  // row + col < SIZE - 1 if step is SIZE + 1. These are the cells that move
+  // forward by k * step under transpose() or anti_transpose(), respectively.
+  template<bitpos k, bitpos step>
+  static inline constexpr cellSet diagonal() {
+    return cellSet{
+      quadSet::repeat_block(quadSet{1}, 2*SIZE - step, SIZE - k)
+    }.template shl<step == SIZE - 1 ? k : SIZE - 1 - k>();
+  }
+
+  // Exchanges diagonal<k, step>() with the cells k * step above it, and then
+  // does the same for each diagonal after it.
+  template<bitpos k, bitpos step>
+  constexpr cellSet swap_diagonals(std::true_type) const {
+    return swap_diagonal<k, step>().template swap_diagonals<k + 1, step>(
+      std::integral_constant<bool, (k + 1 < SIZE)>());
+  }
+
+  template<bitpos k, bitpos step>
+  constexpr cellSet swap_diagonals(std::false_type) const {
+    return *this;
+  }
+
+  template<bitpos k, bitpos step>
+  constexpr cellSet swap_diagonal() const {
+    return swap_delta<k * step>(diagonal<k, step>());
+  }
+
+  // A delta swap: exchanges the cells in mask with the cells delta above them.
+  template<bitpos delta>
+  constexpr cellSet swap_delta(cellSet mask) const {
+    const cellSet t = (shr<delta>() ^ *this) & mask;
+    return *this ^ t ^ t.template fast_shl<delta>();
+  }
 };
 
 //static_assert (std::is_pod< cellset<8> >::value, "cellset must be POD");
@@ -266,4 +475,231 @@ template<bitpos SIZE>
 std::ostream& operator<< (std::ostream &out, cellset<SIZE> set) {
   return set.emit(out);
 }
+
+namespace std {
+template<bitpos SIZE, bitpos BITS>
+struct hash< cellset<SIZE,BITS> > {
+  inline size_t operator()(const cellset<SIZE,BITS> &set) const {
+    return size_t(set.hash());
+  }
+};
+}
+
+
+#ifdef QUADSET_AVX2
+// cellvec_form<QUADWORDS> is the register that holds a cellvec of the given
+// number of quadwords: a pairvec for two quadwords, and a quadvec for three or
+// four (see qset_avx2.h). load() and store() convert a qset to and from it.
+template<bitpos QUADWORDS>
+struct cellvec_form {
+  typedef quadvec type;
+  template<class qSet>
+  static inline type load(qSet s) { return s.to_quadvec(); }
+  template<class qSet>
+  static inline qSet store(type v) { return qSet::from_quadvec(v); }
+};
+
+template<>
+struct cellvec_form<2> {
+  typedef pairvec type;
+  template<class qSet>
+  static inline type load(qSet s) { return s.to_pairvec(); }
+  template<class qSet>
+  static inline qSet store(type v) { return qSet::from_pairvec(v); }
+};
+
+// cellvec_neighbors<SIZE>(v, l, r) is cellset<SIZE>::fast_neighbors() for a
+// set in a register, or for the two sets in a dualvec, given l and r, the
+// register forms of the board without its left and its right column. It finds
+// the same cells with four shifts rather than six: the right and the left
+// neighbors come first, and the neighbors in the rows above and below are
+// then one row's shift of the set with one or the other of those added. For
+// that, l must not have the bits past the last cell, which fast_not() would
+// leave set. Like fast_neighbors(), this may leave garbage in the unused
+// high-order bits.
+template<bitpos SIZE, class Vec>
+inline Vec cellvec_neighbors(Vec v, Vec l, Vec r) {
+  const Vec east = avx2_and(l, avx2_lsh_small<1>(v));
+  const Vec west = avx2_and(r, avx2_rsh_small<1>(v));
+  return avx2_or(avx2_or(east, west), avx2_or(
+      avx2_rsh_small<SIZE>(avx2_or(v, east)),
+      avx2_lsh_small<SIZE>(avx2_or(v, west))));
+}
+
+// cellvec<SIZE> is a two-, three- or four-quadword cellset<SIZE> held in a
+// vector register (see cellvec_form). It provides just the operations used by
+// the flood fills in winner.h, so that a whole fill runs in vector registers.
+// Converting between a cellset and a cellvec costs several instructions, so
+// qset<BITS,2>, qset<BITS,3> and qset<BITS,4> do not use this form for their
+// own operators.
+template<bitpos SIZE>
+class cellvec {
+public:
+  typedef cellvec<SIZE> cellVec;
+  typedef cellset<SIZE> cellSet;
+  typedef quadset<SIZE*SIZE> quadSet;
+  typedef typename quadSet::qSet qSet;
+  typedef cellvec_form<(SIZE*SIZE+63) / 64> form;
+  typedef typename form::type vec;
+
+  vec v;
+
+  static inline cellVec load(cellSet s) {
+    return cellVec{ form::load(s) };
+  }
+
+  inline cellSet store() const {
+    return cellSet{ quadSet{ form::template store<qSet>(v) } };
+  }
+
+  inline bool any() const {
+    return !avx2_none(v);
+  }
+
+  inline bool none() const {
+    return avx2_none(v);
+  }
+
+  inline bitpos count() const {
+    return store().count();
+  }
+
+  inline bool intersects(cellVec other) const {
+    return !avx2_disjoint(v, other.v);
+  }
+
+  inline bool is_subset_of(cellVec other) const {
+    return avx2_subset(v, other.v);
+  }
+
+  inline bool any_andnot(cellVec other) const {
+    return !avx2_subset(v, other.v);
+  }
+
+  inline bitpos count_and(cellVec other) const {
+    return (*this & other).count();
+  }
+
+  inline bool count_at_least(bitpos k) const {
+    return store().count_at_least(k);
+  }
+
+  inline bool union_changed(cellVec other) {
+    const bool changed = !avx2_subset(other.v, v);
+    v = avx2_or(v, other.v);
+    return changed;
+  }
+
+  inline bool operator==(cellVec other) const {
+    return avx2_none(avx2_xor(v, other.v));
+  }
+
+  inline bool operator!=(cellVec other) const {
+    return !this->operator==(other);
+  }
+
+  inline cellVec operator& (cellVec other) const {
+    return cellVec{ avx2_and(v, other.v) };
+  }
+
+  inline cellVec operator| (cellVec other) const {
+    return cellVec{ avx2_or(v, other.v) };
+  }
+
+  // Like cellset<SIZE>::fast_neighbors(), this may leave garbage in the
+  // unused high-order bits (see cellvec_neighbors).
+  inline cellVec fast_neighbors() const {
+    constexpr cellSet l = ~cellSet::left();
+    constexpr cellSet r = ~cellSet::right();
+    return cellVec{
+        cellvec_neighbors<SIZE>(v, form::load(l), form::load(r)) };
+  }
+};
+
+// cellvec_pair<SIZE> is two two-quadword cellvecs in one AVX2 register (a
+// dualvec), so that the flood fills in winner.h grow their start and stop
+// groups with the same instructions. It provides just the operations used
+// there.
+template<bitpos SIZE>
+class cellvec_pair {
+public:
+  typedef cellvec_pair<SIZE> cellVecPair;
+  typedef cellvec<SIZE> cellVec;
+  typedef cellset<SIZE> cellSet;
+
+  static_assert ((SIZE*SIZE+63) / 64 == 2,
+      "cellvec_pair: SIZE must have two-quadword cellsets");
+
+  dualvec v;
+
+  static inline cellVecPair make(cellVec first, cellVec second) {
+    return cellVecPair{ avx2_dual(first.v, second.v) };
+  }
+
+  inline cellVec first() const {
+    return cellVec{ avx2_first(v) };
+  }
+
+  inline cellVec second() const {
+    return cellVec{ avx2_second(v) };
+  }
+
+  // Returns whether the two sets intersect.
+  inline bool halves_intersect() const {
+    return first().intersects(second());
+  }
+
+  // Adds other to this pair, and returns whether either set grew.
+  inline bool union_changed(cellVecPair other) {
+    const bool changed = !avx2_subset(other.v, v);
+    v = avx2_or(v, other.v);
+    return changed;
+  }
+
+  inline cellVecPair operator& (cellVecPair other) const {
+    return cellVecPair{ avx2_and(v, other.v) };
+  }
+
+  // The neighbors of each of the two sets (see cellvec_neighbors).
+  inline cellVecPair fast_neighbors() const {
+    constexpr cellSet l = ~cellSet::left();
+    constexpr cellSet r = ~cellSet::right();
+    const cellVec lv = cellVec::load(l);
+    const cellVec rv = cellVec::load(r);
+    return cellVecPair{ cellvec_neighbors<SIZE>(
+        v, avx2_dual(lv.v, lv.v), avx2_dual(rv.v, rv.v)) };
+  }
+};
+#endif
+
+
+// flood_set<SIZE>::type is the set type that the flood fills in winner.h use
+// for a board of the given size, and flood_set<SIZE>::load() converts a
+// cellset to it. It is cellvec<SIZE> for two-, three- and four-quadword
+// cellsets when AVX2 is available, and cellset<SIZE> otherwise.
+template<bitpos SIZE, bitpos QUADWORDS = (SIZE*SIZE+63) / 64>
+struct flood_set {
+  typedef cellset<SIZE> type;
+  static inline type load(cellset<SIZE> s) { return s; }
+};
+
+#ifdef QUADSET_AVX2
+template<bitpos SIZE>
+struct flood_set<SIZE,2> {
+  typedef cellvec<SIZE> type;
+  static inline type load(cellset<SIZE> s) { return type::load(s); }
+};
+
+template<bitpos SIZE>
+struct flood_set<SIZE,3> {
+  typedef cellvec<SIZE> type;
+  static inline type load(cellset<SIZE> s) { return type::load(s); }
+};
+
+template<bitpos SIZE>
+struct flood_set<SIZE,4> {
+  typedef cellvec<SIZE> type;
+  static inline type load(cellset<SIZE> s) { return type::load(s); }
+};
+#endif
 #endif /* __CELLSET_H__ */
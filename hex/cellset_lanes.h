@@ -0,0 +1,300 @@
+#ifndef __CELLSET_LANES_H__
+#define __CELLSET_LANES_H__ 1
+#include <stdint.h>
+#include <string.h>
+#include <array>
+#include "cellset.h"
+
+// lane_word<W>::type is a vector of W uint64_t values. (GCC ignores the
+// vector_size attribute if its argument depends on a template parameter, so
+// each width is spelled out.)
+template<int W> struct lane_word;
+template<> struct lane_word<1> {
+  typedef uint64_t type __attribute__ ((vector_size (8)));
+};
+template<> struct lane_word<2> {
+  typedef uint64_t type __attribute__ ((vector_size (16)));
+};
+template<> struct lane_word<4> {
+  typedef uint64_t type __attribute__ ((vector_size (32)));
+};
+template<> struct lane_word<8> {
+  typedef uint64_t type __attribute__ ((vector_size (64)));
+};
+template<> struct lane_word<16> {
+  typedef uint64_t type __attribute__ ((vector_size (128)));
+};
+
+
+// The Cellset Lanes Type
+// ======================
+// cellset_lanes<N,W> holds W independent cellset<N> values ("lanes") in
+// structure-of-arrays form: word 0 of every lane, then word 1 of every lane,
+// and so on. Each operation applies the corresponding cellset<N> operation to
+// every lane at once, with the same meaning (including the fast/clean
+// distinction described in quadset.h).
+//
+// Word q of all W lanes is held in one GCC/Clang vector value (see the
+// compilers' "vector extensions"), so each operation is a handful of
+// element-wise vector operations, which the compiler maps onto the widest
+// vector registers the target has: a lane width of 4 fills an AVX2 register,
+// and 8 fills an AVX-512 register (e.g., with -mavx2, -mavx512f, or
+// -march=native). Without vector support the same code runs one lane at a
+// time.
+//
+// Per-lane results, such as any() and operator==, are returned as a bitmask,
+// with bit i describing lane i.
+template<bitpos N, int W>
+class cellset_lanes {
+public:
+  static constexpr bitpos QUADWORDS = (N*N+63) / 64;
+
+  typedef cellset_lanes<N,W> cellsetLanes;
+  typedef cellset<N> cellSet;
+  typedef std::array<bitpos,W> counts;
+
+  static_assert (W == 1 || W == 2 || W == 4 || W == 8 || W == 16,
+      "cellset_lanes: W must be a power of two in 1..16");
+  static_assert (sizeof(cellSet) == QUADWORDS * sizeof(uint64_t),
+      "cellset_lanes: cellset<N> must be exactly QUADWORDS words");
+
+  // A lane word holds one 64-bit word for each of the W lanes.
+  typedef typename lane_word<W>::type laneWord;
+
+  // w[q][i] is word q of lane i.
+  laneWord w[QUADWORDS];
+
+  // Return a value with every lane empty.
+  static inline cellsetLanes make() {
+    cellsetLanes result;
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      result.w[q] = laneWord{};
+    }
+    return result;
+  }
+
+  // Return a value with every lane equal to s.
+  static inline cellsetLanes broadcast(cellSet s) {
+    uint64_t words[QUADWORDS];
+    memcpy(words, &s, sizeof(words));
+    cellsetLanes result;
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      result.w[q] = laneWord{} + words[q];
+    }
+    return result;
+  }
+
+  // Return the mask with one bit set for each lane.
+  static inline constexpr uint32_t all_lanes() {
+    return uint32_t(~0ULL >> (64 - W));
+  }
+
+  // Return lane i.
+  inline cellSet lane(int i) const {
+    uint64_t words[QUADWORDS];
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      words[q] = w[q][i];
+    }
+    cellSet result;
+    memcpy(&result, words, sizeof(words));
+    return result;
+  }
+
+  // Replace lane i with s.
+  inline cellsetLanes& set_lane(int i, cellSet s) {
+    uint64_t words[QUADWORDS];
+    memcpy(words, &s, sizeof(words));
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      w[q][i] = words[q];
+    }
+    return *this;
+  }
+
+  // Clear any set bits in the unused part of the storage of every lane.
+  inline cellsetLanes clean() const {
+    constexpr uint64_t top = (N*N) % 64 == 0 ? ~0ULL :
+                                               ~0ULL >> (64 - (N*N) % 64);
+    cellsetLanes result = *this;
+    result.w[QUADWORDS-1] &= top;
+    return result;
+  }
+
+  // Return the mask of lanes that are nonempty.
+  inline uint32_t any() const {
+    laneWord acc = w[0];
+    for (bitpos q = 1; q < QUADWORDS; ++q) {
+      acc |= w[q];
+    }
+    return nonzero_mask(acc);
+  }
+
+  // Return the mask of lanes that are empty.
+  inline uint32_t none() const {
+    return ~any() & all_lanes();
+  }
+
+  // Return the mask of lanes that equal the corresponding lane of other.
+  inline uint32_t operator==(const cellsetLanes &other) const {
+    return ~(*this ^ other).any() & all_lanes();
+  }
+
+  // Return the mask of lanes that differ from the corresponding lane of other.
+  inline uint32_t operator!=(const cellsetLanes &other) const {
+    return (*this ^ other).any();
+  }
+
+  // Return the number of elements in each lane. It is cloned for CPUs with and
+  // without POPCNT (see BITOPS_CLONES in bitops.h).
+  BITOPS_CLONES
+  counts count() const {
+    counts result;
+    for (int i = 0; i < W; ++i) {
+      result[i] = 0;
+      for (bitpos q = 0; q < QUADWORDS; ++q) {
+        result[i] += countBits(w[q][i]);
+      }
+    }
+    return result;
+  }
+
+  inline cellsetLanes operator& (const cellsetLanes &other) const {
+    cellsetLanes result;
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      result.w[q] = w[q] & other.w[q];
+    }
+    return result;
+  }
+
+  inline cellsetLanes operator| (const cellsetLanes &other) const {
+    cellsetLanes result;
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      result.w[q] = w[q] | other.w[q];
+    }
+    return result;
+  }
+
+  inline cellsetLanes operator^ (const cellsetLanes &other) const {
+    cellsetLanes result;
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      result.w[q] = w[q] ^ other.w[q];
+    }
+    return result;
+  }
+
+  // Returns the lane-wise set difference.
+  inline cellsetLanes operator- (const cellsetLanes &other) const {
+    cellsetLanes result;
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      result.w[q] = w[q] & ~other.w[q];
+    }
+    return result;
+  }
+
+  inline cellsetLanes& operator&= (const cellsetLanes &other) {
+    return *this = *this & other;
+  }
+
+  inline cellsetLanes& operator|= (const cellsetLanes &other) {
+    return *this = *this | other;
+  }
+
+  inline cellsetLanes& operator-= (const cellsetLanes &other) {
+    return *this = *this - other;
+  }
+
+  // Shift every lane left by n (like cellset<N>::fast_lsh(n), this may leave
+  // garbage in the unused high-order bits). Requires 0 ≤ n.
+  inline cellsetLanes fast_lsh(bitpos n) const {
+    const bitpos words = n >> 6;
+    const int bits = n & 0x3F;
+    cellsetLanes result;
+    for (bitpos q = 0; q < words && q < QUADWORDS; ++q) {
+      result.w[q] = laneWord{};
+    }
+    for (bitpos q = words; q < QUADWORDS; ++q) {
+      laneWord v = w[q - words] << bits;
+      if (q > words && bits != 0) {
+        v |= w[q - words - 1] >> (64 - bits);
+      }
+      result.w[q] = v;
+    }
+    return result;
+  }
+
+  inline cellsetLanes operator<<(bitpos n) const {
+    return fast_lsh(n).clean();
+  }
+
+  // Shift every lane right by n. Requires 0 ≤ n.
+  inline cellsetLanes operator>>(bitpos n) const {
+    const bitpos words = n >> 6;
+    const int bits = n & 0x3F;
+    cellsetLanes result;
+    for (bitpos q = 0; q + words < QUADWORDS; ++q) {
+      laneWord v = w[q + words] >> bits;
+      if (q + words + 1 < QUADWORDS && bits != 0) {
+        v |= w[q + words + 1] << (64 - bits);
+      }
+      result.w[q] = v;
+    }
+    for (bitpos q = words > QUADWORDS ? 0 : QUADWORDS - words;
+         q < QUADWORDS; ++q) {
+      result.w[q] = laneWord{};
+    }
+    return result;
+  }
+
+  // Return the neighbors of every lane, as cellset<N>::fast_neighbors() does.
+  inline cellsetLanes fast_neighbors() const {
+    const cellsetLanes l = broadcast(cellSet::left().fast_not());
+    const cellsetLanes r = broadcast(cellSet::right().fast_not());
+    const cellsetLanes &s = *this;
+    return ( (s >> N)
+           | (((s >> (N - 1)) | s.fast_lsh(1)) & l)
+           | ((s.fast_lsh(N - 1) | (s >> 1)) & r)
+           | s.fast_lsh(N)
+           );
+  }
+
+  // Return the mask of lanes in which owned connects start to stop, by the
+  // same flood fill as Board<N>::isConnected(), run on all lanes at once.
+  static inline uint32_t connected(
+      const cellsetLanes &start,
+      const cellsetLanes &owned,
+      const cellsetLanes &stop
+  ) {
+    cellsetLanes startGroup = owned & start;
+    cellsetLanes stopGroup = owned & stop;
+    uint32_t result = 0;
+    uint32_t live = startGroup.any() & stopGroup.any();
+
+    // Flood every lane until it connects or stops growing. Finished lanes go
+    // on being computed (their results are simply ignored), since that costs
+    // nothing extra in a vector instruction.
+    while (live != 0) {
+      cellsetLanes newStartGroup =
+        (startGroup.fast_neighbors() & owned) | startGroup;
+      cellsetLanes newStopGroup =
+        (stopGroup.fast_neighbors() & owned) | stopGroup;
+
+      result |= (newStartGroup & newStopGroup).any() & live;
+      live &= ~result &
+        ((newStartGroup != startGroup) | (newStopGroup != stopGroup));
+
+      startGroup = newStartGroup;
+      stopGroup = newStopGroup;
+    }
+    return result;
+  }
+
+private:
+  static inline uint32_t nonzero_mask(laneWord acc) {
+    uint32_t mask = 0;
+    for (int i = 0; i < W; ++i) {
+      mask |= uint32_t(acc[i] != 0) << i;
+    }
+    return mask;
+  }
+};
+
+#endif /* __CELLSET_LANES_H__ */
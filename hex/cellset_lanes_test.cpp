@@ -0,0 +1,124 @@
+#include <random>
+#include <vector>
+#include "board.h"
+#include "winner.h"
+#include "cellset_lanes.h"
+#include "../quadset/randomsets.h"
+#include "gtest/gtest.h"
+
+
+// TEST has two parameters: the test case name and the test name.
+// The test case name and the test name should both be valid C++
+// identifiers.  And you should not use underscore (_) in the names.
+
+// Checks every lane-wise operation against the same cellset<N> operation
+// applied to each lane separately.
+template<bitpos N, int W>
+void testLaneOps() {
+  typedef cellset_lanes<N,W> Lanes;
+  std::minstd_rand generator;
+  for (int round = 0; round < 20; ++round) {
+    cellset<N> a[W], b[W];
+    Lanes la = Lanes::make(), lb = Lanes::make();
+    for (int i = 0; i < W; ++i) {
+      a[i] = randomSet< cellset<N> >(generator, N*N, round * 5);
+      b[i] = i == 1 ? a[i]
+                    : randomSet< cellset<N> >(generator, N*N, 50);
+      la.set_lane(i, a[i]);
+      lb.set_lane(i, b[i]);
+    }
+
+    uint32_t any = 0, eq = 0;
+    for (int i = 0; i < W; ++i) {
+      EXPECT_EQ(a[i], la.lane(i));
+      any |= uint32_t(a[i].any()) << i;
+      eq |= uint32_t(a[i] == b[i]) << i;
+    }
+    EXPECT_EQ(any, la.any());
+    EXPECT_EQ(~any & Lanes::all_lanes(), la.none());
+    EXPECT_EQ(eq, la == lb);
+    EXPECT_EQ(~eq & Lanes::all_lanes(), la != lb);
+
+    auto counts = la.count();
+    Lanes land = la & lb, lor = la | lb, lxor = la ^ lb, lsub = la - lb;
+    Lanes nbrs = la.fast_neighbors();
+    for (int i = 0; i < W; ++i) {
+      EXPECT_EQ(a[i].count(), counts[i]);
+      EXPECT_EQ(a[i] & b[i], land.lane(i));
+      EXPECT_EQ(a[i] | b[i], lor.lane(i));
+      EXPECT_EQ(a[i] ^ b[i], lxor.lane(i));
+      EXPECT_EQ(a[i] - b[i], lsub.lane(i));
+      EXPECT_EQ(a[i].fast_neighbors().clean(), nbrs.lane(i).clean());
+    }
+
+    for (bitpos n : std::vector<bitpos>{
+           0, 1, N - 1, N, 63, 64, 65, 127, 128, N*N - 1, N*N}) {
+      Lanes lsh = la << n, rsh = la >> n, fast = la.fast_lsh(n);
+      for (int i = 0; i < W; ++i) {
+        EXPECT_EQ(a[i] << n, lsh.lane(i)) << n;
+        EXPECT_EQ(a[i] >> n, rsh.lane(i)) << n;
+        EXPECT_EQ(a[i].fast_lsh(n).clean(), fast.lane(i).clean()) << n;
+      }
+    }
+  }
+}
+
+TEST(CellsetLanes, Ops) {
+  testLaneOps<2, 4>();
+  testLaneOps<8, 4>();
+  testLaneOps<11, 4>();
+  testLaneOps<11, 8>();
+  testLaneOps<13, 4>();
+  testLaneOps<16, 8>();
+  testLaneOps<19, 4>();
+}
+
+TEST(CellsetLanes, Broadcast) {
+  typedef cellset_lanes<11,8> Lanes;
+  auto s = cellset<11>::make({0, 60, 64, 120});
+  auto lanes = Lanes::broadcast(s);
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(s, lanes.lane(i));
+  }
+  EXPECT_EQ(0xFFu, lanes.any());
+  EXPECT_EQ(0u, Lanes::make().any());
+}
+
+// Checks cellset_lanes<N,W>::connected() against Board<N>::winner() on random
+// positions, for both players.
+template<bitpos N, int W>
+void testConnected() {
+  typedef cellset_lanes<N,W> Lanes;
+  std::minstd_rand generator;
+  std::uniform_int_distribution<int> dist(0, 2);
+  for (int round = 0; round < 50; ++round) {
+    Lanes vert = Lanes::make(), horz = Lanes::make();
+    uint32_t xWins = 0, oWins = 0;
+    for (int i = 0; i < W; ++i) {
+      std::string state;
+      for (bitpos cell = 0; cell < N*N; ++cell) {
+        state += "-XO"[dist(generator)];
+      }
+      Board<N> board(state);
+      vert.set_lane(i, board.verticalCells());
+      horz.set_lane(i, board.horizontalCells());
+      xWins |= uint32_t(board.winner('X') == 'X') << i;
+      oWins |= uint32_t(board.winner('O') == 'O') << i;
+    }
+    EXPECT_EQ(xWins, Lanes::connected(
+          Lanes::broadcast(Board<N>::topRow()), vert,
+          Lanes::broadcast(Board<N>::bottomRow())));
+    EXPECT_EQ(oWins, Lanes::connected(
+          Lanes::broadcast(Board<N>::leftColumn()), horz,
+          Lanes::broadcast(Board<N>::rightColumn())));
+  }
+}
+
+TEST(CellsetLanes, Connected) {
+  testConnected<3, 4>();
+  testConnected<8, 8>();
+  testConnected<11, 4>();
+  testConnected<13, 8>();
+  testConnected<16, 4>();
+  testConnected<19, 4>();
+}
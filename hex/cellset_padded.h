@@ -0,0 +1,273 @@
+#ifndef __CELLSET_PADDED_H__
+#define __CELLSET_PADDED_H__ 1
+#include <stdint.h>
+#include "cellset.h"
+
+// The Padded Cellset Type
+// =======================
+// padded_cellset<N> is a set of the cells of an N×N board, like cellset<N>,
+// but with its rows N+1 bits apart rather than N: cell (row, col) is bit
+// row*(N+1) + col, and bit row*(N+1) + N of each row is a guard bit that is
+// never a cell. A set of cells is clean if its guard bits, and the unused
+// high-order bits of its last word, are zero.
+//
+// In the dense layout, shifting a set by 1 or N±1 carries cells from the end
+// of one row to the start of another, which are not neighbors, so
+// cellset<N>::neighbors() has to mask them off with ~left() and ~right().
+// With a guard column every such carry lands in a guard bit instead, so
+// fast_neighbors() below is just the six shifts and their OR; a flood fill that
+// ANDs the neighbors with a clean set of owned cells discards the guard bits
+// along with the other garbage.
+//
+// The guard column costs N bits, which for most board sizes still fits in
+// the same number of words as the dense layout: it takes one more word only
+// for N = 8 (72 bits) and N = 11 (132 bits) among the sizes up to 13.
+// from_cellset() and to_cellset() convert between the layouts, with expand()
+// and compress() (PDEP and PEXT when BMI2 is available), so they cost much
+// more than a flood step; a padded set pays off when it is kept in this
+// layout and flooded many times, as in PaddedBoard<N> (see paddedboard.h).
+template<bitpos SIZE, bitpos BITS = SIZE*(SIZE+1)>
+class padded_cellset : public quadset<SIZE*(SIZE+1)> {
+public:
+  static constexpr bitpos STRIDE = SIZE + 1;
+
+  typedef padded_cellset<SIZE> paddedSet;
+  typedef cellset<SIZE> cellSet;
+  typedef quadset<BITS> quadSet;
+
+  inline constexpr padded_cellset() { quadSet::reset(); }
+  inline constexpr padded_cellset(uint64_t val) : quadSet{val} { }
+  inline constexpr padded_cellset(quadSet val) : quadSet(val) { }
+
+  // Returns the bit of cell (row, col).
+  static inline constexpr bitpos position(bitpos row, bitpos col) {
+    return row*STRIDE + col;
+  }
+
+  // Returns the bit of the cell that is bit cell of a cellset<SIZE>.
+  static inline constexpr bitpos position(bitpos cell) {
+    return cell + cell/SIZE;
+  }
+
+  // Returns all the cells of the board: every bit but the guard bits.
+  static inline constexpr paddedSet cells() {
+    return paddedSet{ quadSet::repeat_block(top(), STRIDE, SIZE) };
+  }
+
+  static inline constexpr paddedSet top() {
+    return paddedSet{ uint64_t(-1LL) >> (64-SIZE) };
+  }
+
+  static inline constexpr paddedSet bottom() {
+    return top().template shl<(SIZE - 1)*STRIDE>();
+  }
+
+  static inline constexpr paddedSet left() {
+    return paddedSet{ quadSet::repeat_block(quadSet{1}, STRIDE, SIZE) };
+  }
+
+  static inline constexpr paddedSet right() {
+    return left().template shl<SIZE - 1>();
+  }
+
+  // from_cellset(dense) returns the cells of dense, in the padded layout.
+  static inline paddedSet from_cellset(cellSet dense) {
+    quadSet spread;
+    for (bitpos q = 0; q < (SIZE*SIZE + 63) / 64; ++q) {
+      spread.set_word(q, dense.word(q));
+    }
+    return paddedSet{ spread.expand(cells()) };
+  }
+
+  // to_cellset() returns the cells of this set, in the dense layout. The set
+  // must be clean.
+  inline cellSet to_cellset() const {
+    const quadSet packed = this->compress(cells());
+    cellSet dense;
+    for (bitpos q = 0; q < (SIZE*SIZE + 63) / 64; ++q) {
+      dense.set_word(q, packed.word(q));
+    }
+    return dense;
+  }
+
+  inline constexpr bool any() const {
+    return this->quadSet::any();
+  }
+
+  inline constexpr bool none() const {
+    return this->quadSet::none();
+  }
+
+  inline constexpr bool test(bitpos pos) const {
+    return this->quadSet::test(pos);
+  }
+
+  inline constexpr bitpos count() const {
+    return this->quadSet::count();
+  }
+
+  inline constexpr bool intersects(paddedSet other) const {
+    return this->quadSet::intersects(other);
+  }
+
+  inline bool count_at_least(bitpos k) const {
+    return this->quadSet::count_at_least(k);
+  }
+
+  inline bool union_changed(paddedSet other) {
+    return this->quadSet::union_changed(other);
+  }
+
+  inline constexpr bool operator==(paddedSet other) const {
+    return this->quadSet::operator==(other);
+  }
+
+  inline constexpr bool operator!=(paddedSet other) const {
+    return this->quadSet::operator!=(other);
+  }
+
+  template<bitpos n>
+  inline constexpr paddedSet shl() const {
+    return paddedSet{ this->quadSet::template shl<n>() };
+  }
+
+  template<bitpos n>
+  inline constexpr paddedSet fast_shl() const {
+    return paddedSet{ this->quadSet::template fast_shl<n>() };
+  }
+
+  template<bitpos n>
+  inline constexpr paddedSet shr() const {
+    return paddedSet{ this->quadSet::template shr<n>() };
+  }
+
+  inline constexpr paddedSet operator& (paddedSet other) const {
+    return paddedSet{ this->quadSet::operator&(other) };
+  }
+
+  inline constexpr paddedSet operator| (paddedSet other) const {
+    return paddedSet{ this->quadSet::operator|(other) };
+  }
+
+  inline constexpr paddedSet operator^ (paddedSet other) const {
+    return paddedSet{ this->quadSet::operator^(other) };
+  }
+
+  inline constexpr paddedSet operator- (paddedSet other) const {
+    return paddedSet{ this->quadSet::operator-(other) };
+  }
+
+  inline paddedSet& set(bitpos n) {
+    this->quadSet::set(n);
+    return *this;
+  }
+
+  inline paddedSet& reset(bitpos n) {
+    this->quadSet::reset(n);
+    return *this;
+  }
+
+  // Like cellset<SIZE>::neighbors(): returns the cells next to a cell of this
+  // set, which must be clean. The result is clean.
+  constexpr paddedSet neighbors() const {
+    return fast_neighbors() & cells();
+  }
+
+  // The neighbors of the cells of this set, which must be clean, with
+  // garbage in the guard bits and the unused high-order bits. Unlike
+  // cellset<SIZE>::fast_neighbors(), it needs no edge masks: the shifts
+  // towards col+1 carry column SIZE-1, and those towards col-1 carry column 0,
+  // into a guard bit of the same row or the row above.
+  constexpr paddedSet fast_neighbors() const {
+    return ( shr<STRIDE>()
+           | shr<STRIDE - 1>()
+           | shr<1>()
+           | fast_shl<1>()
+           | fast_shl<STRIDE - 1>()
+           | fast_shl<STRIDE>()
+           );
+  }
+};
+
+template<bitpos SIZE, bitpos BITS>
+constexpr bitpos padded_cellset<SIZE,BITS>::STRIDE;
+
+#ifdef QUADSET_AVX2
+// padded_cellvec<SIZE> is to padded_cellset<SIZE> what cellvec<SIZE> is to
+// cellset<SIZE>: a three- or four-quadword set held in an AVX2 register,
+// with just the operations used by the flood fills in winner.h.
+template<bitpos SIZE>
+class padded_cellvec {
+public:
+  typedef padded_cellvec<SIZE> paddedVec;
+  typedef padded_cellset<SIZE> paddedSet;
+  typedef quadset<SIZE*(SIZE+1)> quadSet;
+
+  quadvec v;
+
+  static inline paddedVec load(paddedSet s) {
+    return paddedVec{ s.to_quadvec() };
+  }
+
+  inline paddedSet store() const {
+    return paddedSet{ quadSet{ quadSet::qSet::from_quadvec(v) } };
+  }
+
+  inline bool none() const {
+    return avx2_none(v);
+  }
+
+  inline bool intersects(paddedVec other) const {
+    return !avx2_disjoint(v, other.v);
+  }
+
+  inline bool count_at_least(bitpos k) const {
+    return store().count_at_least(k);
+  }
+
+  inline bool union_changed(paddedVec other) {
+    const bool changed = !avx2_subset(other.v, v);
+    v = _mm256_or_si256(v, other.v);
+    return changed;
+  }
+
+  inline paddedVec operator& (paddedVec other) const {
+    return paddedVec{ _mm256_and_si256(v, other.v) };
+  }
+
+  // As padded_cellset<SIZE>::fast_neighbors(), with no masks.
+  inline paddedVec fast_neighbors() const {
+    constexpr int stride = SIZE + 1;
+    return paddedVec{ _mm256_or_si256(
+        _mm256_or_si256(avx2_rsh(v, stride), avx2_lsh(v, stride)),
+        _mm256_or_si256(
+            _mm256_or_si256(avx2_rsh(v, stride - 1), avx2_lsh(v, stride - 1)),
+            _mm256_or_si256(avx2_rsh(v, 1), avx2_lsh(v, 1)))) };
+  }
+};
+#endif
+
+
+// padded_flood_set<SIZE> is flood_set<SIZE> (see cellset.h) for the padded
+// layout: padded_cellvec<SIZE> for three- and four-quadword sets when AVX2
+// is available, and padded_cellset<SIZE> otherwise.
+template<bitpos SIZE, bitpos QUADWORDS = (SIZE*(SIZE+1)+63) / 64>
+struct padded_flood_set {
+  typedef padded_cellset<SIZE> type;
+  static inline type load(padded_cellset<SIZE> s) { return s; }
+};
+
+#ifdef QUADSET_AVX2
+template<bitpos SIZE>
+struct padded_flood_set<SIZE,3> {
+  typedef padded_cellvec<SIZE> type;
+  static inline type load(padded_cellset<SIZE> s) { return type::load(s); }
+};
+
+template<bitpos SIZE>
+struct padded_flood_set<SIZE,4> {
+  typedef padded_cellvec<SIZE> type;
+  static inline type load(padded_cellset<SIZE> s) { return type::load(s); }
+};
+#endif
+#endif /* __CELLSET_PADDED_H__ */
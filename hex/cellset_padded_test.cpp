@@ -0,0 +1,68 @@
+#include <random>
+#include "cellset_padded.h"
+#include "../quadset/randomsets.h"
+#include "gtest/gtest.h"
+
+
+// TEST has two parameters: the test case name and the test name.
+// The test case name and the test name should both be valid C++
+// identifiers.  And you should not use underscore (_) in the names.
+
+// Checks that the padded layout puts each cell where position() says, that
+// the conversions are inverses, that the edges match the dense ones, and that
+// neighbors() and fast_neighbors() agree with cellset<N>::neighbors().
+template<bitpos N>
+void testPadded() {
+  typedef padded_cellset<N> Padded;
+  EXPECT_EQ(cellset<N>::universe(), Padded::cells().to_cellset()) << N;
+  EXPECT_EQ(cellset<N>::top(), Padded::top().to_cellset()) << N;
+  EXPECT_EQ(cellset<N>::bottom(), Padded::bottom().to_cellset()) << N;
+  EXPECT_EQ(cellset<N>::left(), Padded::left().to_cellset()) << N;
+  EXPECT_EQ(cellset<N>::right(), Padded::right().to_cellset()) << N;
+  EXPECT_EQ(N*N, Padded::cells().count()) << N;
+
+  std::minstd_rand generator;
+  for (int round = 0; round < 40; ++round) {
+    const cellset<N> s =
+        randomSet< cellset<N> >(generator, N*N, round * 5 % 101);
+    const Padded p = Padded::from_cellset(s);
+    for (bitpos row = 0; row < N; ++row) {
+      for (bitpos col = 0; col < N; ++col) {
+        const bitpos cell = row*N + col;
+        ASSERT_EQ(Padded::position(row, col), Padded::position(cell));
+        EXPECT_EQ(s.test(cell), p.test(Padded::position(cell))) << N;
+      }
+    }
+    EXPECT_EQ(p, p & Padded::cells()) << N << ": " << s;
+    EXPECT_EQ(s, p.to_cellset()) << N;
+    EXPECT_EQ(s.neighbors(), p.neighbors().to_cellset()) << N << ": " << s;
+    EXPECT_EQ(p.neighbors(), p.fast_neighbors() & Padded::cells()) << N;
+  }
+}
+
+TEST(PaddedCellset, Layout) {
+  testPadded<1>();
+  testPadded<2>();
+  testPadded<3>();
+  testPadded<4>();
+  testPadded<5>();
+  testPadded<6>();
+  testPadded<7>();
+  testPadded<8>();
+  testPadded<9>();
+  testPadded<10>();
+  testPadded<11>();
+  testPadded<12>();
+  testPadded<13>();
+  testPadded<19>();
+}
+
+// The guard column adds a word only for N = 8 and N = 11, up to 13.
+TEST(PaddedCellset, Words) {
+  static_assert(sizeof(padded_cellset<7>) == sizeof(cellset<7>), "7");
+  static_assert(sizeof(padded_cellset<8>) > sizeof(cellset<8>), "8");
+  static_assert(sizeof(padded_cellset<10>) == sizeof(cellset<10>), "10");
+  static_assert(sizeof(padded_cellset<11>) > sizeof(cellset<11>), "11");
+  static_assert(sizeof(padded_cellset<13>) == sizeof(cellset<13>), "13");
+  EXPECT_EQ(8, padded_cellset<7>::STRIDE);
+}
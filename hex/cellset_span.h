@@ -0,0 +1,199 @@
+#ifndef __CELLSET_SPAN_H__
+#define __CELLSET_SPAN_H__ 1
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "cellset.h"
+
+// The Cellset Span Type
+// =====================
+// cellset_span<N> is a view of size() cellset<N> values stored in memory that
+// it does not own, such as a large array or an mmapped file of positions.
+// Each value takes QUADWORDS words, word 0 first (see qset.word()), and
+// consecutive values start stride() words apart. The default stride is
+// QUADWORDS, which is how an array of cellset<N> is laid out; a longer one
+// views one set in each record of a file, such as the vertical or the
+// horizontal cells of the boards in a board file (see boardfile.h). A single
+// value is read or written by copying its words, and the bulk kernels scan
+// the whole span in place.
+//
+// cellset_span<N, const uint64_t> is a read-only view, for example of a file
+// mapped read-only. It has everything but store(), and its mask kernels
+// write to a cellset_span<N>.
+//
+// The bulk kernels below each make one sequential pass over the words. The
+// mask kernels work on blocks of BLOCK values at a time, whose words line up
+// with a repeated copy of the mask, so that each block is a fixed number of
+// whole-vector operations (for example, three AVX2 operations per block of
+// four 13×13 sets). The other kernels are memory-bound loops over the words.
+//
+// The kernels ignore any bits set outside the board (see "Fast and Slow
+// Operators" in quadset.h), such as the player to move that Board.pack()
+// keeps in the last word of the horizontal cells, and the mask kernels write
+// clean sets.
+template<bitpos N, class Word = uint64_t>
+class cellset_span {
+public:
+  static constexpr bitpos QUADWORDS = (N*N+63) / 64;
+  static constexpr size_t BLOCK = 4;
+
+  typedef cellset_span<N> cellsetSpan; // A span that the kernels write to.
+  typedef cellset<N> cellSet;
+
+  static_assert (sizeof(cellSet) == QUADWORDS * sizeof(uint64_t),
+      "cellset_span: cellset<N> must be exactly QUADWORDS words");
+  static_assert (std::is_same<Word, uint64_t>::value ||
+      std::is_same<Word, const uint64_t>::value,
+      "cellset_span: Word must be uint64_t or const uint64_t");
+
+  // cellset_span(words, size, stride) views the size sets of QUADWORDS words
+  // that start at words, words + stride, words + 2*stride, and so on.
+  // Requires stride ≥ QUADWORDS.
+  cellset_span(Word *words, size_t size, size_t stride = QUADWORDS)
+    : words(words), length(size), step(stride) { }
+
+  // Returns the number of sets in the span.
+  inline size_t size() const { return length; }
+
+  // Returns the first word of the span.
+  inline Word *data() const { return words; }
+
+  // Returns the number of words from the start of one set to the next.
+  inline size_t stride() const { return step; }
+
+  // Returns the sets from first to first + count - 1, which must be within
+  // the span.
+  inline cellset_span subspan(size_t first, size_t count) const {
+    return cellset_span(words + first * step, count, step);
+  }
+
+  // Returns a copy of set i, without any bits outside the board.
+  inline cellSet operator[](size_t i) const {
+    cellSet result;
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      result.set_word(q, words[i * step + q] & valid(q));
+    }
+    return result;
+  }
+
+  // Replaces set i with s. Only for a span of uint64_t.
+  inline void store(size_t i, cellSet s) const {
+    for (bitpos q = 0; q < QUADWORDS; ++q) {
+      words[i * step + q] = s.word(q);
+    }
+  }
+
+  // Writes set i & mask to set i of out, for every i, where out has the same
+  // size as this span. out may be this span itself.
+  inline void and_mask(cellSet mask, cellsetSpan out) const {
+    apply_mask(mask, out, [](uint64_t w, uint64_t m) { return w & m; });
+  }
+
+  // Writes set i | mask to set i of out, for every i.
+  inline void or_mask(cellSet mask, cellsetSpan out) const {
+    apply_mask(mask, out, [](uint64_t w, uint64_t m) { return w | m; });
+  }
+
+  // Writes set i - mask to set i of out, for every i.
+  inline void andnot_mask(cellSet mask, cellsetSpan out) const {
+    apply_mask(mask, out, [](uint64_t w, uint64_t m) { return w & ~m; });
+  }
+
+  // Writes the number of elements of set i to counts[i], for every i. It is
+  // cloned for CPUs with and without POPCNT (see BITOPS_CLONES in bitops.h).
+  BITOPS_CLONES
+  void count(bitpos *counts) const {
+    const uint64_t *w = words;
+    for (size_t i = 0; i < length; ++i, w += step) {
+      bitpos n = 0;
+      for (bitpos q = 0; q < QUADWORDS; ++q) {
+        n += countBits(w[q] & valid(q));
+      }
+      counts[i] = n;
+    }
+  }
+
+  // Sets bit i % 64 of bits[i / 64] to whether set i contains cell, for
+  // every i, and clears the rest of the last word. bits must have room for
+  // (size() + 63) / 64 words.
+  inline void test(bitpos cell, uint64_t *bits) const {
+    const uint64_t *w = words + (cell >> 6);
+    const int shift = cell & 0x3F;
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+      uint64_t result = 0;
+      for (int j = 0; j < 64; ++j, w += step) {
+        result |= ((*w >> shift) & 1) << j;
+      }
+      *bits++ = result;
+    }
+    if (i < length) {
+      uint64_t result = 0;
+      for (int j = 0; i < length; ++i, ++j, w += step) {
+        result |= ((*w >> shift) & 1) << j;
+      }
+      *bits = result;
+    }
+  }
+
+  // Writes to indices, in increasing order, the index i of every set for
+  // which pred(set i) is true, and returns how many there are. pred is any
+  // function of a cellSet; it is called with each set in turn, copied into
+  // registers from the span. indices must have room for size() entries.
+  template<class Pred>
+  inline size_t filter(Pred pred, size_t *indices) const {
+    size_t found = 0;
+    for (size_t i = 0; i < length; ++i) {
+      indices[found] = i;
+      found += pred((*this)[i]) ? 1 : 0;
+    }
+    return found;
+  }
+
+private:
+  Word *words;
+  size_t length;
+  size_t step;
+
+  // Returns the cells of the board in word q of a set.
+  static inline constexpr uint64_t valid(bitpos q) {
+    return cellSet::universe().word(q);
+  }
+
+  // Writes op(word, mask word), without the bits outside the board, for
+  // every word of every set to out. When both spans are packed (their stride
+  // is QUADWORDS), whole blocks go through block-sized copies of the mask and
+  // of the board, in loops of fixed length that the compiler turns into
+  // vector operations. Otherwise each set is done on its own.
+  template<class Op>
+  inline void apply_mask(cellSet mask, cellsetSpan out, Op op) const {
+    const uint64_t *in = words;
+    uint64_t *o = out.data();
+    if (step != QUADWORDS || out.stride() != QUADWORDS) {
+      for (size_t i = 0; i < length; ++i, in += step, o += out.stride()) {
+        for (bitpos q = 0; q < QUADWORDS; ++q) {
+          o[q] = op(in[q], mask.word(q)) & valid(q);
+        }
+      }
+      return;
+    }
+    uint64_t m[BLOCK * QUADWORDS], v[BLOCK * QUADWORDS];
+    for (size_t j = 0; j < BLOCK * QUADWORDS; ++j) {
+      m[j] = mask.word(j % QUADWORDS);
+      v[j] = valid(j % QUADWORDS);
+    }
+    size_t i = 0;
+    for (; i + BLOCK <= length; i += BLOCK) {
+      for (size_t j = 0; j < BLOCK * QUADWORDS; ++j) {
+        o[j] = op(in[j], m[j]) & v[j];
+      }
+      in += BLOCK * QUADWORDS;
+      o += BLOCK * QUADWORDS;
+    }
+    for (size_t j = 0; j < (length - i) * QUADWORDS; ++j) {
+      o[j] = op(in[j], m[j]) & v[j];
+    }
+  }
+};
+
+#endif /* __CELLSET_SPAN_H__ */
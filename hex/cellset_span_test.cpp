@@ -0,0 +1,183 @@
+#include <random>
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+#include "cellset_span.h"
+#include "boardfile.h"
+#include "../quadset/randomsets.h"
+#include "gtest/gtest.h"
+
+
+// TEST has two parameters: the test case name and the test name.
+// The test case name and the test name should both be valid C++
+// identifiers.  And you should not use underscore (_) in the names.
+
+// Checks every bulk kernel against the same cellset<N> operation applied to
+// each set of the span, for span sizes that do and do not fill whole blocks
+// and whole words of test() results.
+template<bitpos N>
+void testSpanOps() {
+  typedef cellset_span<N> Span;
+  std::minstd_rand generator;
+  for (size_t size : std::vector<size_t>{0, 1, 3, 4, 7, 64, 130}) {
+    std::vector<cellset<N>> sets;
+    std::vector<uint64_t> storage(size * Span::QUADWORDS);
+    Span span(storage.data(), size);
+    for (size_t i = 0; i < size; ++i) {
+      sets.push_back(
+          randomSet< cellset<N> >(generator, N*N, (i * 7) % 100));
+      span.store(i, sets[i]);
+    }
+    ASSERT_EQ(size, span.size());
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(sets[i], span[i]);
+    }
+
+    const cellset<N> mask = randomSet< cellset<N> >(generator, N*N, 50);
+    std::vector<uint64_t> outStorage(storage.size());
+    Span out(outStorage.data(), size);
+    span.and_mask(mask, out);
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(sets[i] & mask, out[i]) << N << " " << size << " " << i;
+    }
+    span.or_mask(mask, out);
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(sets[i] | mask, out[i]) << N << " " << size << " " << i;
+    }
+    span.andnot_mask(mask, out);
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(sets[i] - mask, out[i]) << N << " " << size << " " << i;
+    }
+
+    std::vector<bitpos> counts(size);
+    span.count(counts.data());
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(sets[i].count(), counts[i]) << N << " " << size << " " << i;
+    }
+
+    for (bitpos cell : std::vector<bitpos>{0, 1, N*N / 2, N*N - 1}) {
+      std::vector<uint64_t> bits((size + 63) / 64, ~0ULL);
+      span.test(cell, bits.data());
+      for (size_t i = 0; i < bits.size() * 64; ++i) {
+        EXPECT_EQ(i < size && sets[i].test(cell),
+                  ((bits[i / 64] >> (i % 64)) & 1) != 0)
+          << N << " " << size << " " << i << " " << cell;
+      }
+    }
+
+    std::vector<size_t> indices(size);
+    size_t found = span.filter(
+        [&](cellset<N> s) { return s.intersects(mask) && s.count() > N; },
+        indices.data());
+    size_t expected = 0;
+    for (size_t i = 0; i < size; ++i) {
+      if (sets[i].intersects(mask) && sets[i].count() > N) {
+        ASSERT_LT(expected, found);
+        EXPECT_EQ(i, indices[expected]);
+        ++expected;
+      }
+    }
+    EXPECT_EQ(expected, found);
+
+    // In place, on a subspan.
+    if (size > 2) {
+      Span middle = span.subspan(1, size - 2);
+      middle.and_mask(mask, middle);
+      EXPECT_EQ(sets[0], span[0]);
+      for (size_t i = 1; i + 1 < size; ++i) {
+        EXPECT_EQ(sets[i] & mask, span[i]) << N << " " << size << " " << i;
+      }
+      EXPECT_EQ(sets[size - 1], span[size - 1]);
+    }
+  }
+}
+
+TEST(CellsetSpan, Ops) {
+  testSpanOps<1>();
+  testSpanOps<5>();
+  testSpanOps<8>();
+  testSpanOps<11>();
+  testSpanOps<13>();
+  testSpanOps<16>();
+  testSpanOps<19>();
+}
+
+// Scans the vertical and the horizontal cells of the boards of a board file,
+// through read-only spans whose stride is the length of a record, and checks
+// that the player to move, which is kept in the horizontal cells' last word,
+// is not seen as a cell.
+template<bitpos N>
+void testBoardFileSpans() {
+  typedef cellset_span<N, const uint64_t> ConstSpan;
+  std::minstd_rand generator(N);
+  std::vector< Board<N> > boards;
+  for (int round = 0; round < 70; ++round) {
+    Board<N> b;
+    for (int i = 0; i < N*N; ++i) {
+      if (generator() % 3 == 0) {
+        b.go(i);
+      }
+    }
+    boards.push_back(b);
+  }
+  const std::string path = std::string(P_tmpdir) + "/cellset_span_test." +
+      std::to_string(getpid());
+  BoardFileWriter<N>(path).write(boards.data(), boards.size());
+
+  {
+    const BoardFile<N> file(path);
+    const uint64_t *records = file.record(0);
+    const ConstSpan vert(records, file.size(), Board<N>::recordWords);
+    const ConstSpan horz(records + ConstSpan::QUADWORDS, file.size(),
+                         Board<N>::recordWords);
+    ASSERT_EQ(boards.size(), vert.size());
+    for (size_t i = 0; i < boards.size(); ++i) {
+      EXPECT_EQ(boards[i].verticalCells(), vert[i]) << N << " " << i;
+      EXPECT_EQ(boards[i].horizontalCells(), horz[i]) << N << " " << i;
+    }
+
+    std::vector<bitpos> counts(boards.size());
+    horz.count(counts.data());
+    for (size_t i = 0; i < boards.size(); ++i) {
+      EXPECT_EQ(boards[i].horizontalCells().count(), counts[i])
+        << N << " " << i;
+    }
+
+    const bitpos cell = N*N / 2;
+    std::vector<uint64_t> bits((boards.size() + 63) / 64);
+    vert.test(cell, bits.data());
+    for (size_t i = 0; i < boards.size(); ++i) {
+      EXPECT_EQ(boards[i].verticalCells().test(cell),
+                ((bits[i / 64] >> (i % 64)) & 1) != 0) << N << " " << i;
+    }
+
+    const cellset<N> mask = randomSet< cellset<N> >(generator, N*N, 50);
+    std::vector<uint64_t> outStorage(boards.size() * ConstSpan::QUADWORDS);
+    cellset_span<N> out(outStorage.data(), boards.size());
+    horz.or_mask(mask, out);
+    for (size_t i = 0; i < boards.size(); ++i) {
+      EXPECT_EQ(boards[i].horizontalCells() | mask, out[i]) << N << " " << i;
+      EXPECT_EQ(out[i], out[i].clean()) << N << " " << i;
+    }
+
+    std::vector<size_t> indices(boards.size());
+    const size_t found = vert.subspan(10, 50).filter(
+        [&](cellset<N> s) { return s.intersects(mask); }, indices.data());
+    size_t expected = 0;
+    for (size_t i = 10; i < 60; ++i) {
+      if (boards[i].verticalCells().intersects(mask)) {
+        ASSERT_LT(expected, found);
+        EXPECT_EQ(i - 10, indices[expected]);
+        ++expected;
+      }
+    }
+    EXPECT_EQ(expected, found);
+  }
+  unlink(path.c_str());
+}
+
+TEST(CellsetSpan, BoardFile) {
+  testBoardFileSpans<5>();
+  testBoardFileSpans<8>();
+  testBoardFileSpans<13>();
+}
@@ -0,0 +1,160 @@
+#include <random>
+#include "cellset.h"
+#include "../quadset/randomsets.h"
+#include "gtest/gtest.h"
+
+
+// TEST has two parameters: the test case name and the test name.
+// The test case name and the test name should both be valid C++
+// identifiers.  And you should not use underscore (_) in the names.
+
+// Checks rotate180(), transpose(), and anti_transpose() cell by cell, and
+// checks that each is an involution that commutes with neighbors().
+template<bitpos N>
+void testSymmetries() {
+  std::minstd_rand generator;
+  for (int round = 0; round < 40; ++round) {
+    const cellset<N> s =
+        randomSet< cellset<N> >(generator, N*N, round * 5 % 101);
+    cellset<N> rot = s.rotate180();
+    cellset<N> tr = s.transpose();
+    cellset<N> anti = s.anti_transpose();
+    for (bitpos row = 0; row < N; ++row) {
+      for (bitpos col = 0; col < N; ++col) {
+        const bool in = s.test(row*N + col);
+        EXPECT_EQ(in, rot.test((N-1-row)*N + (N-1-col))) << N << ": " << s;
+        EXPECT_EQ(in, tr.test(col*N + row)) << N << ": " << s;
+        EXPECT_EQ(in, anti.test((N-1-col)*N + (N-1-row))) << N << ": " << s;
+      }
+    }
+    EXPECT_EQ(rot, rot.clean()) << N << ": " << s;
+    EXPECT_EQ(tr, tr.clean()) << N << ": " << s;
+    EXPECT_EQ(anti, anti.clean()) << N << ": " << s;
+    EXPECT_EQ(s, rot.rotate180()) << N;
+    EXPECT_EQ(s, tr.transpose()) << N;
+    EXPECT_EQ(s, anti.anti_transpose()) << N;
+    EXPECT_EQ(anti, tr.rotate180()) << N;
+    EXPECT_EQ(rot.neighbors(), s.neighbors().rotate180()) << N << ": " << s;
+    EXPECT_EQ(tr.neighbors(), s.neighbors().transpose()) << N << ": " << s;
+    EXPECT_EQ(anti.neighbors(), s.neighbors().anti_transpose())
+      << N << ": " << s;
+  }
+}
+
+TEST(Cellset, Symmetries) {
+  testSymmetries<1>();
+  testSymmetries<2>();
+  testSymmetries<3>();
+  testSymmetries<4>();
+  testSymmetries<5>();
+  testSymmetries<6>();
+  testSymmetries<7>();
+  testSymmetries<8>();
+  testSymmetries<9>();
+  testSymmetries<10>();
+  testSymmetries<11>();
+  testSymmetries<12>();
+  testSymmetries<13>();
+  testSymmetries<16>();
+  testSymmetries<19>();
+}
+
+TEST(Cellset, TransposeEdges) {
+  EXPECT_EQ(cellset<11>::left(), cellset<11>::top().transpose());
+  EXPECT_EQ(cellset<11>::bottom(), cellset<11>::right().transpose());
+  EXPECT_EQ(cellset<11>::right(), cellset<11>::top().anti_transpose());
+  EXPECT_EQ(cellset<11>::bottom(), cellset<11>::top().rotate180());
+}
+
+// Checks crop<K>() and embed() cell by cell, for every window position of
+// a few window shapes.
+template<bitpos N, bitpos K>
+void testCropEmbed() {
+  std::minstd_rand generator;
+  const cellset<N> s = randomSet< cellset<N> >(generator, N*N, 50);
+  const bitpos shapes[][2] = {{K, K}, {K, 1}, {1, K}, {K - 1, K / 2 + 1}};
+  for (auto &shape : shapes) {
+    const bitpos rows = shape[0], cols = shape[1];
+    for (bitpos row = 0; row + rows <= N; ++row) {
+      for (bitpos col = 0; col + cols <= N; ++col) {
+        const cellset<K> part = s.template crop<K>(row, col, rows, cols);
+        const cellset<N> back = cellset<N>::embed(part, row, col, rows, cols);
+        for (bitpos r = 0; r < K; ++r) {
+          for (bitpos c = 0; c < K; ++c) {
+            const bool inside = r < rows && c < cols;
+            EXPECT_EQ(inside && s.test((row + r)*N + col + c),
+                      part.test(r*K + c))
+              << N << " " << K << " " << rows << "x" << cols
+              << " at " << row << "," << col << ": " << s;
+          }
+        }
+        EXPECT_EQ(s & cellset<N>::rectangle(row, col, rows, cols), back)
+          << N << " " << K << " " << rows << "x" << cols
+          << " at " << row << "," << col << ": " << s;
+      }
+    }
+  }
+}
+
+TEST(Cellset, CropEmbed) {
+  testCropEmbed<3, 2>();
+  testCropEmbed<8, 8>();
+  testCropEmbed<11, 4>();
+  testCropEmbed<13, 5>();
+  testCropEmbed<13, 8>();
+  testCropEmbed<13, 9>();
+  testCropEmbed<19, 13>();
+}
+
+TEST(Cellset, Rectangle) {
+  EXPECT_EQ(cellset<5>::make({7, 8, 12, 13}), cellset<5>::rectangle(1, 2, 2, 2));
+  EXPECT_EQ(cellset<5>::universe(), cellset<5>::rectangle(0, 0, 5, 5));
+  EXPECT_EQ(cellset<5>::make(), cellset<5>::rectangle(4, 4, 0, 1));
+}
+
+#ifdef QUADSET_AVX2
+// Checks that cellvec<N> finds the same neighbors as cellset<N>.
+template<bitpos N>
+void testCellvecNeighbors() {
+  std::minstd_rand generator;
+  for (int percent : {1, 5, 20, 50, 100}) {
+    for (int round = 0; round < 20; ++round) {
+      const cellset<N> s = randomSet< cellset<N> >(generator, N*N, percent);
+      EXPECT_EQ(s.neighbors(), cellvec<N>::load(s).fast_neighbors().store() &
+                               cellset<N>::universe()) << N << ": " << s;
+    }
+  }
+}
+
+// Checks that cellvec_pair<N> finds the neighbors of each of its sets.
+template<bitpos N>
+void testCellvecPairNeighbors() {
+  typedef cellvec<N> Vec;
+  std::minstd_rand generator;
+  for (int percent : {1, 5, 20, 50, 100}) {
+    for (int round = 0; round < 20; ++round) {
+      const cellset<N> a = randomSet< cellset<N> >(generator, N*N, percent);
+      const cellset<N> b = randomSet< cellset<N> >(generator, N*N, 30);
+      const cellvec_pair<N> pair =
+          cellvec_pair<N>::make(Vec::load(a), Vec::load(b)).fast_neighbors();
+      EXPECT_EQ(a.neighbors(), pair.first().store() &
+                               cellset<N>::universe()) << N << ": " << a;
+      EXPECT_EQ(b.neighbors(), pair.second().store() &
+                               cellset<N>::universe()) << N << ": " << b;
+    }
+  }
+}
+
+TEST(Cellset, CellvecNeighbors) {
+  testCellvecNeighbors<9>();
+  testCellvecNeighbors<10>();
+  testCellvecNeighbors<11>();
+  testCellvecNeighbors<12>();
+  testCellvecNeighbors<13>();
+  testCellvecNeighbors<14>();
+  testCellvecNeighbors<16>();
+  testCellvecPairNeighbors<9>();
+  testCellvecPairNeighbors<10>();
+  testCellvecPairNeighbors<11>();
+}
+#endif
@@ -0,0 +1,204 @@
+#ifndef __HEXCONNECTIVITY_H__
+#define __HEXCONNECTIVITY_H__ 1
+#include <stdint.h>
+#include <utility>
+#include "panic.h"
+#include "cellset.h"
+
+// A Connectivity<N> follows the moves of a game on an N×N board, and keeps
+// each player's cells in groups of connected cells, so that whether a player
+// has won is a comparison of two group representatives instead of a flood
+// fill. It is a union-find structure with one node per cell and four virtual
+// nodes for the edges of the board: an X cell in the top row is joined to
+// TOP, an O cell in the left column to LEFT, and so on, and X has won when
+// TOP and BOTTOM are in the same group.
+//
+// go() joins the new cell to the groups of its owned neighbors, and undo()
+// takes back the last move, so a Connectivity can follow a search that plays
+// and undoes moves (see Board.track()). To make that possible, groups are
+// joined by rank and paths are never compressed: every join is logged, and
+// undo() reverses the joins of the last move. Without path compression, a
+// group representative is still at most log2(N*N+4) links from any node.
+template<bitpos N>
+class Connectivity {
+public:
+  typedef cellset<N> cellSet;
+
+  static constexpr int count = N*N; // The number of cells.
+  static constexpr int TOP = count;        // The virtual top edge node.
+  static constexpr int BOTTOM = count + 1; // The virtual bottom edge node.
+  static constexpr int LEFT = count + 2;   // The virtual left edge node.
+  static constexpr int RIGHT = count + 3;  // The virtual right edge node.
+  static constexpr int nodes = count + 4;
+
+  // Connectivity() follows a game on an empty board.
+  Connectivity() { reset(cellSet(), cellSet()); }
+
+  // Connectivity(vertical, horizontal) follows a game on a board on which the
+  // vertical and horizontal players own the given cells.
+  Connectivity(cellSet vertical, cellSet horizontal) {
+    reset(vertical, horizontal);
+  }
+
+  // reset(vertical, horizontal) starts over, from a board on which the
+  // vertical and horizontal players own the given cells. Those cells cannot
+  // be undone. Panics if a cell is owned by both.
+  Connectivity<N>& reset(cellSet vertical, cellSet horizontal) {
+    if (vertical.intersects(horizontal)) {
+      panic("Connectivity.reset(vertical, horizontal): both own %s",
+          (vertical & horizontal).to_string().c_str());
+    }
+    for (int i = 0; i < nodes; ++i) {
+      parent[i] = i;
+      rank[i] = 0;
+    }
+    owned[0] = owned[1] = cellSet();
+    joinCount = 0;
+    for (bitpos cell : vertical) {
+      claim(cell, 0);
+    }
+    for (bitpos cell : horizontal) {
+      claim(cell, 1);
+    }
+    moveCount = 0;
+    return *this;
+  }
+
+  // go(at, player) records that player ('X' or 'O') claims cell at.
+  // Panics if at is an illegal index or already owned, or if player is not
+  // 'X' or 'O'.
+  Connectivity<N>& go(int at, char player) {
+    if (at < 0 || at >= count) {
+      panic("Connectivity.go(%d): cell numbers must be between 0 and %d",
+          at, count - 1);
+    } else if (player != 'X' && player != 'O') {
+      panic("Connectivity.go(%d, p): p must be 'X' or 'O'; was '%c'",
+          at, player);
+    } else if (owned[0].test(at) || owned[1].test(at)) {
+      panic("Connectivity.go(%d) by %c: that cell is already owned",
+          at, player);
+    }
+    moves[moveCount].cell = at;
+    moves[moveCount].joins = joinCount;
+    ++moveCount;
+    claim(at, player == 'X' ? 0 : 1);
+    return *this;
+  }
+
+  // undo(at) takes back the last move that go() recorded, which must have
+  // been at cell at. Panics if it was not, or if there are no moves to take
+  // back.
+  Connectivity<N>& undo(int at) {
+    if (moveCount == 0 || moves[moveCount - 1].cell != at) {
+      panic("Connectivity.undo(%d): the last move was %d", at,
+          moveCount == 0 ? -1 : int(moves[moveCount - 1].cell));
+    }
+    --moveCount;
+    while (joinCount > moves[moveCount].joins) {
+      const uint16_t join = joins[--joinCount];
+      const int child = join >> 1;
+      if (join & 1) {
+        --rank[parent[child]];
+      }
+      parent[child] = child;
+    }
+    owned[0].reset(at);
+    owned[1].reset(at);
+    return *this;
+  }
+
+  // winner() returns 'X', 'O', or '?', as Board.winner() does, for the
+  // board that this Connectivity follows.
+  char winner(char testFor='?') const {
+    if (testFor != 'O' && connected(TOP, BOTTOM)) {
+      return 'X';
+    }
+    if (testFor != 'X' && connected(LEFT, RIGHT)) {
+      return 'O';
+    }
+    return '?';
+  }
+
+  // Returns whether nodes a and b, each a cell or an edge node, are in the
+  // same group.
+  bool connected(int a, int b) const { return find(a) == find(b); }
+
+  // Returns the number of moves that undo() can take back.
+  int moveDepth() const { return moveCount; }
+
+private:
+  // A move is the cell that go() claimed, and the number of joins logged
+  // before it.
+  struct move {
+    uint16_t cell;
+    uint16_t joins;
+  };
+
+  uint16_t parent[nodes]; // parent[i] == i if node i represents its group.
+  uint8_t rank[nodes];    // An upper bound on the height of the group tree.
+  cellSet owned[2];       // owned[0] is X's cells, owned[1] is O's.
+
+  // joins[i] records the i'th join still in effect: (child << 1) | 1 if the
+  // new parent's rank went up, else child << 1. There are fewer joins than
+  // nodes, since each one reduces the number of groups.
+  uint16_t joins[nodes];
+  int joinCount;
+  move moves[count];
+  int moveCount;
+
+  // Returns the node that represents node i's group.
+  int find(int i) const {
+    while (parent[i] != i) {
+      i = parent[i];
+    }
+    return i;
+  }
+
+  // Joins the groups of nodes a and b, if they differ, and logs the join.
+  void join(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) {
+      return;
+    }
+    if (rank[a] < rank[b]) {
+      std::swap(a, b);
+    }
+    parent[b] = a;
+    const bool taller = rank[a] == rank[b];
+    rank[a] += taller;
+    joins[joinCount++] = uint16_t((b << 1) | taller);
+  }
+
+  // Gives cell at to owned[player], and joins it to its owned neighbors and
+  // to the player's edge nodes that it touches.
+  void claim(int at, int player) {
+    owned[player].set(at);
+    const int row = at / N, col = at % N;
+    const int offsets[6][2] = {{0,-1}, {0,1}, {-1,0}, {1,0}, {1,-1}, {-1,1}};
+    for (auto &d : offsets) {
+      const int r = row + d[0], c = col + d[1];
+      if (r >= 0 && r < N && c >= 0 && c < N && owned[player].test(r*N + c)) {
+        join(at, r*N + c);
+      }
+    }
+    if (player == 0) {
+      if (row == 0) join(at, TOP);
+      if (row == N-1) join(at, BOTTOM);
+    } else {
+      if (col == 0) join(at, LEFT);
+      if (col == N-1) join(at, RIGHT);
+    }
+  }
+
+  static_assert (N >= 1 && N <= 19, "Connectivity size must be in 1..19");
+};
+
+template<bitpos N> const int Connectivity<N>::count;
+template<bitpos N> const int Connectivity<N>::TOP;
+template<bitpos N> const int Connectivity<N>::BOTTOM;
+template<bitpos N> const int Connectivity<N>::LEFT;
+template<bitpos N> const int Connectivity<N>::RIGHT;
+template<bitpos N> const int Connectivity<N>::nodes;
+
+#endif /* __HEXCONNECTIVITY_H__ */
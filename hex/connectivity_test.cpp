@@ -0,0 +1,120 @@
+#include <random>
+#include <vector>
+#include "board.h"
+#include "winner.h"
+#include "randomgame.h"
+#include "gtest/gtest.h"
+
+
+// TEST has two parameters: the test case name and the test name.
+// The test case name and the test name should both be valid C++
+// identifiers.  And you should not use underscore (_) in the names.
+
+// Plays random games on a tracked and an untracked Board<N>, checking after
+// every move that the tracked winner() agrees with the flood fill, then
+// undoes every move, checking again at each step.
+template<bitpos N>
+void testTrackedGames() {
+  std::minstd_rand generator(N);
+  for (int game = 0; game < 20; ++game) {
+    const std::vector<int> cells = randomGame<N>(generator);
+
+    Connectivity<N> connectivity;
+    Board<N> tracked, flooded;
+    tracked.track(&connectivity);
+    for (int cell : cells) {
+      tracked.go(cell);
+      flooded.go(cell);
+      for (char testFor : {'X', 'O', '?'}) {
+        ASSERT_EQ(flooded.winner(testFor), tracked.winner(testFor))
+          << N << " " << testFor << std::endl << flooded;
+      }
+    }
+    ASSERT_EQ(N*N, connectivity.moveDepth());
+    for (auto it = cells.rbegin(); it != cells.rend(); ++it) {
+      tracked.undo(*it);
+      flooded.undo(*it);
+      for (char testFor : {'X', 'O', '?'}) {
+        ASSERT_EQ(flooded.winner(testFor), tracked.winner(testFor))
+          << N << " " << testFor << std::endl << flooded;
+      }
+    }
+    EXPECT_EQ(0, connectivity.moveDepth());
+  }
+}
+
+TEST(Connectivity, TrackedGames) {
+  testTrackedGames<1>();
+  testTrackedGames<2>();
+  testTrackedGames<3>();
+  testTrackedGames<5>();
+  testTrackedGames<8>();
+  testTrackedGames<11>();
+  testTrackedGames<13>();
+  testTrackedGames<19>();
+}
+
+TEST(Connectivity, Track) {
+  Board<3> b(R"(X - -
+                 X O -
+                  - O -)");
+  Connectivity<3> connectivity;
+  b.track(&connectivity);
+  EXPECT_EQ('?', b.winner());
+  EXPECT_EQ(0, connectivity.moveDepth());
+  EXPECT_TRUE(connectivity.connected(0, Connectivity<3>::TOP));
+  EXPECT_TRUE(connectivity.connected(0, 3));
+  EXPECT_FALSE(connectivity.connected(4, Connectivity<3>::LEFT));
+
+  b.go(6);
+  EXPECT_EQ('X', b.winner());
+  EXPECT_EQ('?', b.winner('O'));
+  b.undo(6);
+  EXPECT_EQ('?', b.winner());
+
+  // A copy is not tracked; assignment and embed() reset the tracker.
+  Board<3> copy(b);
+  copy.go(6);
+  EXPECT_EQ(0, connectivity.moveDepth());
+  b = copy;
+  EXPECT_EQ('X', b.winner());
+  EXPECT_EQ(0, connectivity.moveDepth());
+  b.embed(Board<1>(), 2, 0);
+  EXPECT_EQ('?', b.winner());
+
+  b.track(nullptr);
+  b.go(5).go(6);
+  EXPECT_EQ(0, connectivity.moveDepth());
+}
+
+TEST(Connectivity, Panics) {
+  Connectivity<3> connectivity(cellset<3>::make({0}), cellset<3>());
+  EXPECT_THROW(connectivity.undo(0), Panic);
+  EXPECT_THROW(connectivity.go(0, 'O'), Panic);
+  EXPECT_THROW(connectivity.go(9, 'X'), Panic);
+  EXPECT_THROW(connectivity.go(1, '?'), Panic);
+  connectivity.go(1, 'O').go(2, 'X');
+  EXPECT_THROW(connectivity.undo(1), Panic);
+  connectivity.undo(2).undo(1);
+  EXPECT_THROW(Connectivity<3>(cellset<3>::make({4}), cellset<3>::make({4})),
+               Panic);
+}
+
+// Undoing a move other than the last one on a tracked board panics, and
+// leaves the board and its tracker as they were.
+TEST(Connectivity, UndoOutOfOrder) {
+  Connectivity<3> connectivity;
+  Board<3> b;
+  b.track(&connectivity);
+  b.go(0).go(4).go(8);
+  const Board<3> before = b;
+  EXPECT_THROW(b.undo(0), Panic);
+  EXPECT_EQ(before, b);
+  EXPECT_EQ('O', b.player());
+  EXPECT_EQ(before.hash(), b.hash());
+  EXPECT_EQ(Board<3>(b.verticalCells(), b.horizontalCells(), b.player())
+                .hash(), b.hash());
+  EXPECT_EQ(3, connectivity.moveDepth());
+  b.undo(8).undo(4).undo(0);
+  EXPECT_EQ(Board<3>(), b);
+}
@@ -0,0 +1,111 @@
+#ifndef __HEXPADDEDBOARD_H__
+#define __HEXPADDEDBOARD_H__ 1
+#include "panic.h"
+#include "cellset_padded.h"
+#include "board.h"
+#include "winner.h"
+
+// A PaddedBoard<N> holds the same position as a Board<N>, with its cells in
+// padded_cellset<N> form, so that winner() and virtualWinner() flood without
+// edge masks. It is for code that tests many positions for a win, such as a
+// solver's leaf checks; it keeps no hash and no tracker, and converts to a
+// Board<N> for everything else. Cell numbers in go() are Board<N>'s.
+template<bitpos N>
+class PaddedBoard {
+public:
+  typedef padded_cellset<N> paddedSet;
+
+  // PaddedBoard() creates an empty board, with X to play.
+  PaddedBoard() : play('X'), vert{0}, horz{0} { }
+
+  // PaddedBoard(b) holds the position of b.
+  explicit PaddedBoard(const Board<N> &b)
+      : play(b.player()),
+        vert(paddedSet::from_cellset(b.verticalCells())),
+        horz(paddedSet::from_cellset(b.horizontalCells())) { }
+
+  // Returns the position as a Board<N>.
+  Board<N> board() const {
+    return Board<N>(vert.to_cellset(), horz.to_cellset(), play);
+  }
+
+  char player() const { return play; }
+
+  paddedSet verticalCells() const { return vert; }
+  paddedSet horizontalCells() const { return horz; }
+  paddedSet emptyCells() const {
+    constexpr paddedSet cells = paddedSet::cells();
+    return cells - vert - horz;
+  }
+
+  // go(at) is Board<N>.go(at), without the hash. Panics if the cell is not
+  // on the board, or is owned.
+  PaddedBoard<N>& go(int at) {
+    if (at < 0 || at >= N*N) {
+      panic("PaddedBoard.go(%d): cell numbers must be between 0 and %d", at,
+          int(N*N - 1));
+    }
+    const bitpos pos = paddedSet::position(at);
+    if (vert.test(pos) || horz.test(pos)) {
+      panic("PaddedBoard.go(%d) by %c: that cell is owned", at, play);
+    }
+    (play == 'X' ? vert : horz).set(pos);
+    play = 'X' + 'O' - play;
+    return *this;
+  }
+
+  // winner() and virtualWinner() are as for Board<N>.
+  char winner(char testFor='?') const {
+    constexpr paddedSet top = paddedSet::top();
+    constexpr paddedSet bottom = paddedSet::bottom();
+    constexpr paddedSet left = paddedSet::left();
+    constexpr paddedSet right = paddedSet::right();
+    if (testFor != 'O' && connected(top, vert, bottom)) {
+      return 'X';
+    }
+    if (testFor != 'X' && connected(left, horz, right)) {
+      return 'O';
+    }
+    return '?';
+  }
+
+  char virtualWinner(char testFor='?') const {
+    constexpr paddedSet top = paddedSet::top();
+    constexpr paddedSet bottom = paddedSet::bottom();
+    constexpr paddedSet left = paddedSet::left();
+    constexpr paddedSet right = paddedSet::right();
+    const paddedSet vacant = emptyCells();
+    if (testFor != 'O' && virtuallyConnected(top, vert, bottom, vacant)) {
+      return 'X';
+    }
+    if (testFor != 'X' && virtuallyConnected(left, horz, right, vacant)) {
+      return 'O';
+    }
+    return '?';
+  }
+
+private:
+  char play; // 'X' if vertical to play, 'O' if horizontal
+  paddedSet vert; // Cells owned by the vertical player.
+  paddedSet horz; // Cells owned by the horizontal player.
+
+  // On a 1×1 board the start and stop edges are the same cell, which
+  // floodConnects() would not see, since neither group grows.
+  static bool connected(paddedSet start, paddedSet owned, paddedSet stop) {
+    typedef padded_flood_set<N> Flood;
+    return N == 1 ? owned.test(0)
+                  : floodConnects(Flood::load(start), Flood::load(owned),
+                                  Flood::load(stop));
+  }
+
+  static bool virtuallyConnected(paddedSet start, paddedSet owned,
+                                 paddedSet stop, paddedSet vacant) {
+    typedef padded_flood_set<N> Flood;
+    return N == 1 ? owned.test(0)
+                  : floodVirtuallyConnects(Flood::load(start),
+                        Flood::load(owned), Flood::load(stop),
+                        Flood::load(vacant));
+  }
+};
+
+#endif /* __HEXPADDEDBOARD_H__ */
@@ -0,0 +1,361 @@
+#ifndef __HEXPOSITIONRANK_H__
+#define __HEXPOSITIONRANK_H__ 1
+#include <stdint.h>
+#include "panic.h"
+#include "board.h"
+
+// Ranking Positions
+// =================
+// A legal position on an N×N board is one in which X owns as many cells as O,
+// or one more; the player to move is then implied (X if the counts are equal,
+// else O). rankPosition() and unrankPosition() are a bijection between the
+// legal positions and the numbers from 0 to legalPositions<N>() - 1, so that
+// a table indexed by rank holds one entry per position, with none wasted.
+//
+// Positions are ranked by the number k of owned cells, then by the set of
+// owned cells, then by which of those cells are X's, by their positions
+// within the owned cells. Both sets are ranked among the sets of their size
+// in blocks of 12 cells: cells 0 to 11, 12 to 23, and 24 up. A set ranks
+// first by how many of its cells are in the top block, then by which those
+// are, then likewise by the middle block, and last by its cells in the low
+// block. The cells within a block are ranked among those of the same number
+// by the combinatorial number system, as C(c_1, 1) + C(c_2, 2) + ... for
+// c_1 < c_2 < ..., which lowSubsets tabulates for all 4096 subsets of a
+// block. So ranking a set costs a few lookups and multiplications rather
+// than a step per cell, and unranking it a few compares more.
+//
+// The number of positions grows as 3^(N*N), and exceeds 2^64 for N = 7, so
+// these are for boards up to 6×6.
+
+// Binomials holds the binomial coefficients C(n, k) for n and k up to the
+// number of cells on a 6×6 board, computed at compile time by Pascal's rule.
+struct Binomials {
+  static constexpr int max = 36;
+  uint64_t c[max + 1][max + 1];
+
+  constexpr Binomials() : c{} {
+    for (int n = 0; n <= max; ++n) {
+      c[n][0] = 1;
+      for (int k = 1; k <= n; ++k) {
+        c[n][k] = c[n-1][k-1] + (k < n ? c[n-1][k] : 0);
+      }
+    }
+  }
+};
+
+constexpr Binomials binomials{};
+
+// RankOffsets<N> holds, for each number k of owned cells, the rank of the
+// first legal N×N position with k owned cells; offset[N*N+1] is the number of
+// legal positions. The three entries after it are the largest uint64_t, so
+// that unrankCells() can compare a rank with the offsets four at a time.
+template<bitpos N>
+struct RankOffsets {
+  static_assert (N >= 1 && N <= 6, "Positions can be ranked for N in 1..6");
+  uint64_t offset[N*N + 5];
+
+  constexpr RankOffsets() : offset{} {
+    for (int k = 0; k <= N*N; ++k) {
+      offset[k + 1] = offset[k] +
+          binomials.c[N*N][k] * binomials.c[k][(k + 1) / 2];
+    }
+    for (int k = N*N + 2; k < N*N + 5; ++k) {
+      offset[k] = ~uint64_t(0);
+    }
+  }
+};
+
+template<bitpos N>
+constexpr RankOffsets<N> rankOffsets{};
+
+// Returns the number of legal N×N positions.
+template<bitpos N>
+constexpr uint64_t legalPositions() {
+  return rankOffsets<N>.offset[N*N + 1];
+}
+
+// Splits lets unrankCells() divide by a binomial coefficient with a
+// multiplication, which is several times faster than a 64-bit division: for
+// a dividend below 2^bits, the quotient by C(n, k) is
+// dividend * multiplier[n][k] >> shift[n][k] (Granlund and Montgomery's
+// method).
+struct Splits {
+  static constexpr int bits = 58;
+  uint64_t multiplier[Binomials::max + 1][Binomials::max + 1];
+  int shift[Binomials::max + 1][Binomials::max + 1];
+
+  constexpr Splits() : multiplier{}, shift{} {
+    for (int n = 0; n <= Binomials::max; ++n) {
+      for (int k = 0; k <= n; ++k) {
+        const uint64_t divisor = binomials.c[n][k];
+        int log = 0;
+        while (uint64_t(1) << log < divisor) {
+          ++log;
+        }
+        shift[n][k] = bits + log;
+        multiplier[n][k] = uint64_t(
+            ((unsigned __int128)(1) << shift[n][k]) / divisor + 1);
+      }
+    }
+  }
+
+  // Returns dividend / C(n, k). Requires dividend < 2^bits and k ≤ n.
+  constexpr uint64_t quotient(uint64_t dividend, int n, int k) const {
+    return uint64_t((unsigned __int128)(dividend) * multiplier[n][k] >>
+                    shift[n][k]);
+  }
+};
+
+constexpr Splits splits{};
+
+static_assert(legalPositions<6>() <= uint64_t(1) << Splits::bits,
+              "Splits must cover every rank");
+
+// LowSubsets lists the subsets of a block of 12 cells by size and then by
+// rank: mask[offset[i] + r] is the i-cell subset whose rank is r, and
+// rank[m] is the rank of subset m among those of its size, of which there
+// are size[m]. A subset of the lowest n cells of the block ranks below
+// C(n, i), so these serve for blocks of fewer cells too.
+struct LowSubsets {
+  static constexpr int cells = 12;
+  uint16_t offset[cells + 1];
+  uint16_t mask[1 << cells];
+  uint16_t rank[1 << cells];
+  uint8_t size[1 << cells];
+
+  constexpr LowSubsets() : offset{}, mask{}, rank{}, size{} {
+    for (int i = 0; i < cells; ++i) {
+      offset[i + 1] = offset[i] + binomials.c[cells][i];
+    }
+    for (int m = 0; m < 1 << cells; ++m) {
+      int i = 0;
+      uint64_t r = 0;
+      for (int c = 0; c < cells; ++c) {
+        if ((m >> c) & 1) {
+          r += binomials.c[c][++i];
+        }
+      }
+      mask[offset[i] + r] = m;
+      rank[m] = r;
+      size[m] = i;
+    }
+  }
+};
+
+constexpr LowSubsets lowSubsets{};
+
+// Blocks holds the shares of a rank that come from the number of cells in
+// the middle and top blocks. For a set of j cells among those below the top
+// of block g (g = 1 for the middle block, 2 for the top one), where block g
+// has n cells, before[g - 1][n][j][c] is the number of such sets with fewer
+// than c cells in block g, the sum over c' < c of C(n, c') C(12g, j - c').
+struct Blocks {
+  static constexpr int cells = LowSubsets::cells;
+  uint64_t before[2][cells + 1][Binomials::max + 1][cells + 1];
+
+  constexpr Blocks() : before{} {
+    for (int g = 1; g <= 2; ++g) {
+      for (int n = 0; n <= cells; ++n) {
+        for (int j = 0; j <= Binomials::max; ++j) {
+          for (int c = 1; c <= cells; ++c) {
+            before[g - 1][n][j][c] = before[g - 1][n][j][c - 1] +
+                (j >= c - 1 ? binomials.c[n][c - 1] *
+                     binomials.c[cells * g][j - (c - 1)] : 0);
+          }
+        }
+      }
+    }
+  }
+};
+
+constexpr Blocks blocks{};
+
+// Deposits holds PDEP and PEXT for six bits: deposit[m][b] scatters the
+// low-order bits of b to the positions of the 1's in m, of which there are
+// count[m], and extract[m][b] gathers the bits of b at those positions into
+// its low-order bits.
+struct Deposits {
+  uint8_t deposit[64][64];
+  uint8_t extract[64][64];
+  uint8_t count[64];
+
+  constexpr Deposits() : deposit{}, extract{}, count{} {
+    for (int m = 0; m < 64; ++m) {
+      for (int b = 0; b < 64; ++b) {
+        int used = 0, bits = 0, gathered = 0;
+        for (int c = 0; c < 6; ++c) {
+          if ((m >> c) & 1) {
+            gathered |= ((b >> c) & 1) << used;
+            bits |= ((b >> used++) & 1) << c;
+          }
+        }
+        deposit[m][b] = bits;
+        extract[m][b] = gathered;
+        count[m] = used;
+      }
+    }
+  }
+};
+
+constexpr Deposits deposits{};
+
+// subsetRank(s, n, count) returns the rank of the set s of cells 0 to n - 1
+// among the sets of its size, and sets count to its size.
+constexpr uint64_t subsetRank(uint64_t s, int n, int &count) {
+  constexpr int cells = LowSubsets::cells;
+  constexpr uint64_t block = (1 << cells) - 1;
+  const int topCells = n > 2*cells ? n - 2*cells : 0;
+  const int midCells = n > cells ? n - cells - topCells : 0;
+  const int lowCells = n - midCells - topCells;
+  const int low = s & block, mid = (s >> cells) & block, top = s >> 2*cells;
+  const int a = lowSubsets.size[low], b = lowSubsets.size[mid];
+  const int c = lowSubsets.size[top];
+  count = a + b + c;
+  return blocks.before[1][topCells][count][c] +
+      lowSubsets.rank[top] * binomials.c[n - topCells][a + b] +
+      blocks.before[0][midCells][a + b][b] +
+      lowSubsets.rank[mid] * binomials.c[lowCells][a] + lowSubsets.rank[low];
+}
+
+// blockSize(before, rank) returns the number of a set's cells in a block,
+// given before for the block and the set's size (see Blocks), and what
+// remains of the set's rank: the number of before[1] to before[12] that are
+// at most the rank.
+constexpr int blockSize(const uint64_t *before, uint64_t rank) {
+  // Four sums rather than one, so the compares do not wait on each other.
+  int c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+  for (int c = 1; c <= LowSubsets::cells; c += 4) {
+    c0 += before[c] <= rank;
+    c1 += before[c + 1] <= rank;
+    c2 += before[c + 2] <= rank;
+    c3 += before[c + 3] <= rank;
+  }
+  return c0 + c1 + c2 + c3;
+}
+
+// unrankSubset(rank, n, count) returns the set of count cells among cells 0
+// to n - 1 whose rank is rank, which must be less than C(n, count).
+constexpr uint64_t unrankSubset(uint64_t rank, int n, int count) {
+  constexpr int cells = LowSubsets::cells;
+  const int topCells = n > 2*cells ? n - 2*cells : 0;
+  const int midCells = n > cells ? n - cells - topCells : 0;
+  const int lowCells = n - midCells - topCells;
+
+  const uint64_t *topBefore = blocks.before[1][topCells][count];
+  const int c = blockSize(topBefore, rank);
+  rank -= topBefore[c];
+  const uint64_t topRank = splits.quotient(rank, n - topCells, count - c);
+  rank -= topRank * binomials.c[n - topCells][count - c];
+
+  const uint64_t *midBefore = blocks.before[0][midCells][count - c];
+  const int b = blockSize(midBefore, rank);
+  rank -= midBefore[b];
+  const int a = count - c - b;
+  const uint64_t midRank = splits.quotient(rank, lowCells, a);
+  rank -= midRank * binomials.c[lowCells][a];
+
+  return uint64_t(lowSubsets.mask[lowSubsets.offset[c] + topRank]) << 2*cells |
+      uint64_t(lowSubsets.mask[lowSubsets.offset[b] + midRank]) << cells |
+      lowSubsets.mask[lowSubsets.offset[a] + rank];
+}
+
+// rankCells<N>(x, o, xs, os) returns the rank of the legal position in which
+// X owns the cells whose bits are set in x, and O those in o, and sets xs
+// and os to the numbers of those cells. x and o must be disjoint sets of
+// cells of an N×N board; the rank is meaningful only if x has as many cells
+// as o, or one more. rankCells<N>(x, o) returns just the rank.
+//
+// It gathers X's cells into the positions they have among the owned cells,
+// six cells at a time with deposits, and ranks that set and the owned cells
+// with subsetRank().
+template<bitpos N>
+constexpr uint64_t rankCells(uint64_t x, uint64_t o, int &xs, int &os) {
+  const uint64_t occupied = x | o;
+  uint64_t xOfOccupied = 0;
+  int below = 0;
+  for (int c = 0; c < N*N; c += 6) {
+    const int cells = (occupied >> c) & 63;
+    xOfOccupied |= uint64_t(deposits.extract[cells][(x >> c) & 63]) << below;
+    below += deposits.count[cells];
+  }
+  int k = 0;
+  const uint64_t occupiedRank = subsetRank(occupied, N*N, k);
+  const uint64_t xRank = subsetRank(xOfOccupied, k, xs);
+  os = k - xs;
+  return rankOffsets<N>.offset[k] +
+      occupiedRank * binomials.c[k][xs] + xRank;
+}
+
+template<bitpos N>
+constexpr uint64_t rankCells(uint64_t x, uint64_t o) {
+  int xs = 0, os = 0;
+  return rankCells<N>(x, o, xs, os);
+}
+
+// unrankCells<N>(rank, x, o) sets x and o to the cells of X and O in the
+// legal position of the given rank, which must be less than
+// legalPositions<N>().
+//
+// It splits the rank into the rank of the owned cells and the rank of X's
+// cells among them, decodes both with unrankSubset(), which do not depend on
+// each other, and places X's cells in the owned cells with deposits.
+template<bitpos N>
+constexpr void unrankCells(uint64_t rank, uint64_t &x, uint64_t &o) {
+  // Four sums rather than one, so the compares do not wait on each other.
+  int k0 = 0, k1 = 0, k2 = 0, k3 = 0;
+  for (int i = 1; i <= N*N; i += 4) {
+    k0 += rankOffsets<N>.offset[i] <= rank;
+    k1 += rankOffsets<N>.offset[i + 1] <= rank;
+    k2 += rankOffsets<N>.offset[i + 2] <= rank;
+    k3 += rankOffsets<N>.offset[i + 3] <= rank;
+  }
+  const int k = k0 + k1 + k2 + k3;
+  rank -= rankOffsets<N>.offset[k];
+  const int xs = (k + 1) / 2;
+  const uint64_t occupiedRank = splits.quotient(rank, k, xs);
+  const uint64_t xRank = rank - occupiedRank * binomials.c[k][xs];
+  const uint64_t occupied = unrankSubset(occupiedRank, N*N, k);
+  const uint64_t xOfOccupied = unrankSubset(xRank, k, xs);
+
+  x = 0;
+  int below = 0;
+  for (int c = 0; c < N*N; c += 6) {
+    const int cells = (occupied >> c) & 63;
+    x |= uint64_t(deposits.deposit[cells][(xOfOccupied >> below) & 63]) << c;
+    below += deposits.count[cells];
+  }
+  o = occupied ^ x;
+}
+
+// rankPosition(b) returns the rank of b. Panics unless b is a legal position
+// with the implied player to move.
+template<bitpos N>
+uint64_t rankPosition(const Board<N> &b) {
+  int xs = 0, os = 0;
+  const uint64_t rank = rankCells<N>(
+      b.verticalCells().word(0), b.horizontalCells().word(0), xs, os);
+  if ((xs != os && xs != os + 1) || b.player() != (xs == os ? 'X' : 'O')) {
+    panic("rankPosition(): %d X's and %d O's with %c to move is not legal",
+        xs, os, b.player());
+  }
+  return rank;
+}
+
+// unrankPosition<N>(rank) returns the legal position of the given rank.
+// Panics unless rank < legalPositions<N>().
+template<bitpos N>
+Board<N> unrankPosition(uint64_t rank) {
+  if (rank >= legalPositions<N>()) {
+    panic("unrankPosition<%d>(%llu): there are only %llu positions", int(N),
+        (unsigned long long)rank, (unsigned long long)legalPositions<N>());
+  }
+  uint64_t x = 0, o = 0;
+  unrankCells<N>(rank, x, o);
+  typename Board<N>::cellSet vert, horz;
+  vert.set_word(0, x);
+  horz.set_word(0, o);
+  // X moves if X and O own as many cells, that is, an even number in all.
+  return Board<N>(vert, horz, countBits(x | o) % 2 == 0 ? 'X' : 'O');
+}
+
+#endif /* __HEXPOSITIONRANK_H__ */
@@ -0,0 +1,135 @@
+#include <random>
+#include <vector>
+#include "positionrank.h"
+#include "gtest/gtest.h"
+
+
+// TEST has two parameters: the test case name and the test name.
+// The test case name and the test name should both be valid C++
+// identifiers.  And you should not use underscore (_) in the names.
+
+TEST(PositionRank, Binomials) {
+  EXPECT_EQ(1u, binomials.c[0][0]);
+  EXPECT_EQ(10u, binomials.c[5][2]);
+  EXPECT_EQ(0u, binomials.c[2][5]);
+  EXPECT_EQ(9075135300u, binomials.c[36][18]);
+}
+
+// Checks that subsetRank() gives the subsets of each size of the first n
+// cells the ranks 0 to C(n, size) - 1, each once, and that unrankSubset()
+// inverts it: for all the subsets of 14 cells, which span two blocks, and for
+// random subsets of 30 cells, which span three.
+TEST(PositionRank, Subsets) {
+  const int n = 14;
+  std::vector< std::vector<bool> > seen;
+  for (int size = 0; size <= n; ++size) {
+    seen.push_back(std::vector<bool>(binomials.c[n][size]));
+  }
+  for (uint64_t s = 0; s < uint64_t(1) << n; ++s) {
+    int size = 0;
+    const uint64_t rank = subsetRank(s, n, size);
+    ASSERT_LT(rank, binomials.c[n][size]) << s;
+    EXPECT_FALSE(seen[size][rank]) << s;
+    seen[size][rank] = true;
+    EXPECT_EQ(s, unrankSubset(rank, n, size)) << s;
+  }
+  std::minstd_rand generator;
+  for (int round = 0; round < 10000; ++round) {
+    const uint64_t s = generator() & ((uint64_t(1) << 30) - 1);
+    int size = 0;
+    const uint64_t rank = subsetRank(s, 30, size);
+    ASSERT_LT(rank, binomials.c[30][size]) << s;
+    EXPECT_EQ(s, unrankSubset(rank, 30, size)) << s;
+  }
+}
+
+// Visits every assignment of the N×N cells to X, O, or nobody, and checks
+// that the legal ones get the ranks 0 to legalPositions<N>() - 1, each once,
+// and that unrankPosition() inverts rankPosition().
+template<bitpos N>
+void testAllPositions() {
+  std::vector<bool> seen(legalPositions<N>());
+  uint64_t legal = 0;
+  int owner[N*N] = {};
+  for (;;) {
+    uint64_t x = 0, o = 0;
+    for (int i = 0; i < N*N; ++i) {
+      x |= uint64_t(owner[i] == 1) << i;
+      o |= uint64_t(owner[i] == 2) << i;
+    }
+    const int xs = countBits(x), os = countBits(o);
+    if (xs == os || xs == os + 1) {
+      ++legal;
+      typename Board<N>::cellSet vert, horz;
+      vert.set_word(0, x);
+      horz.set_word(0, o);
+      const Board<N> b(vert, horz, xs == os ? 'X' : 'O');
+      const uint64_t rank = rankPosition(b);
+      ASSERT_LT(rank, legalPositions<N>()) << b;
+      EXPECT_FALSE(seen[rank]) << rank << std::endl << b;
+      seen[rank] = true;
+      EXPECT_EQ(b, unrankPosition<N>(rank)) << rank;
+    }
+    int i = 0;
+    while (i < N*N && owner[i] == 2) {
+      owner[i++] = 0;
+    }
+    if (i == N*N) {
+      break;
+    }
+    ++owner[i];
+  }
+  EXPECT_EQ(legalPositions<N>(), legal);
+}
+
+TEST(PositionRank, AllPositions) {
+  testAllPositions<1>();
+  testAllPositions<2>();
+  testAllPositions<3>();
+}
+
+// Checks random ranks, and the positions of random games, on boards too big
+// to enumerate.
+template<bitpos N>
+void testRandomPositions() {
+  std::minstd_rand generator(N);
+  std::uniform_int_distribution<uint64_t> dist(0, legalPositions<N>() - 1);
+  for (int round = 0; round < 1000; ++round) {
+    const uint64_t rank = dist(generator);
+    EXPECT_EQ(rank, rankPosition(unrankPosition<N>(rank))) << N;
+  }
+  for (int game = 0; game < 20; ++game) {
+    Board<N> b;
+    EXPECT_EQ(0u, rankPosition(b));
+    for (int i = 0; i < N*N; ++i) {
+      if (generator() % 2 == 0) {
+        b.go(i);
+        EXPECT_EQ(b, unrankPosition<N>(rankPosition(b))) << N;
+      }
+    }
+  }
+  // The first and last ranks with each number of owned cells.
+  for (int k = 0; k <= N*N; ++k) {
+    const uint64_t first = rankOffsets<N>.offset[k];
+    const uint64_t last = rankOffsets<N>.offset[k + 1] - 1;
+    EXPECT_EQ(first, rankPosition(unrankPosition<N>(first))) << N << " " << k;
+    EXPECT_EQ(last, rankPosition(unrankPosition<N>(last))) << N << " " << k;
+  }
+}
+
+TEST(PositionRank, RandomPositions) {
+  testRandomPositions<4>();
+  testRandomPositions<5>();
+  testRandomPositions<6>();
+}
+
+TEST(PositionRank, Counts) {
+  // Sums over k of C(N*N, k) C(k, (k+1)/2).
+  static_assert(legalPositions<1>() == 2, "1×1");
+  static_assert(legalPositions<2>() == 1 + 4 + 12 + 12 + 6, "2×2");
+  static_assert(rankCells<2>(1, 0) == 1, "rankCells is constexpr");
+  EXPECT_EQ(3u, rankCells<2>(0x4, 0));
+  EXPECT_THROW(rankPosition(Board<3>("OO-X-----")), Panic);
+  EXPECT_THROW(rankPosition(Board<3>().setPlayer('O')), Panic);
+  EXPECT_THROW(unrankPosition<3>(legalPositions<3>()), Panic);
+}
@@ -0,0 +1,28 @@
+#ifndef __HEXRANDOMGAME_H__
+#define __HEXRANDOMGAME_H__ 1
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "board.h"
+
+// randomGame<N>(generator) returns the N*N cells of an N×N board in a random
+// order, drawn from generator: the moves of a game that fills the board, for
+// tests and benchmarks that play random games. randomGame<N>(seed) draws
+// them from a generator seeded with seed.
+template<bitpos N>
+std::vector<int> randomGame(std::minstd_rand &generator) {
+  std::vector<int> cells;
+  for (int i = 0; i < N*N; ++i) {
+    cells.push_back(i);
+  }
+  std::shuffle(cells.begin(), cells.end(), generator);
+  return cells;
+}
+
+template<bitpos N>
+std::vector<int> randomGame(unsigned seed) {
+  std::minstd_rand generator(seed);
+  return randomGame<N>(generator);
+}
+
+#endif /* __HEXRANDOMGAME_H__ */
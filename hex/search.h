@@ -194,28 +194,68 @@ public:
     return this->cmp(other) >= 0;
   }
 
+  // minimum_fork returns the cheapest (by cost()) solid fork made of a subset
+  // of this fork's tines, keeping them in their original order. Among equally
+  // cheap subsets, it returns the one whose mask of tine indexes is smallest.
+  //
+  // Subsets are visited by size, smallest first, as bitmasks of tine indexes
+  // (see nextCombination), and are tested and priced from the tines' cells
+  // and costs without building a Pattern for each. A subset of k tines costs
+  // at least 1 + 100k² plus the k cheapest tine costs; once that bound
+  // exceeds the cost of the cheapest solid fork found so far, no larger
+  // subset can do as well, so the search stops.
   Pattern<SIZE> minimum_fork() {
     assert(kind == FORK);
     assert(this->is_solid());
-    Pattern<SIZE> cheapest_fork = *this;
-    int cheapest_cost = cheapest_fork.cost();
-    int tine_count = this->subs.size();
-    int limit_set = 1 << tine_count;
-    for (int subset = 3; subset < limit_set; ++subset) {
-      Pattern<SIZE> subset_fork({});
-      for (int tine = 0; tine < this->subs.size(); ++tine) {
-        if (((1 << tine) & subset) != 0) {
-          subset_fork.add_subpattern(this->subs[tine]);
-        }
+    const int tine_count = this->subs.size();
+    if (tine_count > 63) {
+      panic("Pattern.minimum_fork(): %d tines is too many", tine_count);
+    }
+
+    cellSet tine_cells[63];
+    int tine_costs[63], sorted_costs[63];
+    for (int tine = 0; tine < tine_count; ++tine) {
+      tine_cells[tine] = this->subs[tine].cells();
+      tine_costs[tine] = sorted_costs[tine] = this->subs[tine].cost();
+    }
+    std::sort(sorted_costs, sorted_costs + tine_count);
+
+    const uint64_t all_tines = (1ULL << tine_count) - 1;
+    uint64_t cheapest_mask = all_tines;
+    int cheapest_cost = this->cost();
+    int cheapest_tines = tine_count > 0 ? sorted_costs[0] : 0;
+    // A single tine is never solid, since a tine's cells are never empty.
+    for (int k = 2; k < tine_count; ++k) {
+      cheapest_tines += sorted_costs[k-1];
+      const int fixed_cost = 1 + 100 * k * k;
+      if (fixed_cost + cheapest_tines > cheapest_cost) {
+        break;
       }
-      if (subset_fork.is_solid()) {
-        int cost = subset_fork.cost();
-        if (cost < cheapest_cost) {
+      for (uint64_t subset = (1ULL << k) - 1;
+           subset != 0 && subset <= all_tines;
+           subset = nextCombination(subset)) {
+        int cost = fixed_cost;
+        cellSet overlap = cellSet::universe();
+        for (uint64_t rest = subset; rest != 0; rest &= rest - 1) {
+          const int tine = lowestBitPosition(rest);
+          cost += tine_costs[tine];
+          overlap &= tine_cells[tine];
+        }
+        if (overlap.none() && (cost < cheapest_cost ||
+            (cost == cheapest_cost && subset < cheapest_mask))) {
           cheapest_cost = cost;
-          cheapest_fork = subset_fork;
+          cheapest_mask = subset;
         }
       }
     }
+
+    if (cheapest_mask == all_tines) {
+      return *this;
+    }
+    Pattern<SIZE> cheapest_fork = empty_fork();
+    for (uint64_t rest = cheapest_mask; rest != 0; rest &= rest - 1) {
+      cheapest_fork.add_subpattern(this->subs[lowestBitPosition(rest)]);
+    }
     return cheapest_fork;
   }
 
@@ -382,18 +422,16 @@ public:
 
 template<bitpos SIZE>
 std::vector<bitpos> shuffled_set_elements(cellset<SIZE> set) {
-  std::vector<bitpos> result;
-  while (set.any()) {
-    bitpos p = set.min();
-    set.reset(p);
-    result.push_back(p);
-  }
+  std::vector<bitpos> result(set.begin(), set.end());
   std::random_shuffle(result.begin(), result.end());
   return result;
 }
 
+// search_in_place() is search(), except that it plays its candidate moves on
+// b and undoes them, instead of copying b for each one. b is unchanged when it
+// returns.
 template<bitpos SIZE>
-char search(const Board<SIZE> &b, Pattern<SIZE> &via, std::string indent="") {
+char search_in_place(Board<SIZE> &b, Pattern<SIZE> &via, std::string indent) {
   const bool DEBUG = false;
   char me = b.player();
 
@@ -417,10 +455,11 @@ char search(const Board<SIZE> &b, Pattern<SIZE> &via, std::string indent="") {
       continue; // Don't bother checking moves that we know will lose.
     }
 
-    auto new_board = Board<SIZE>(b).go(n);
-    auto w = new_board.winner(me);
+    b.go(n);
+    auto w = b.winner(me);
 
     if (w == me) {
+      b.undo(n);
       if (DEBUG) std::cout << indent << me << " moving at " << n
                            << " is an immediate win" << std::endl;
       my_cheapest_win = Pattern<SIZE>(n);
@@ -434,7 +473,8 @@ char search(const Board<SIZE> &b, Pattern<SIZE> &via, std::string indent="") {
     Pattern<SIZE> patt;
     if (DEBUG) std::cout << indent << "recurring after move at " << n
                          << std::endl;
-    w = search(new_board, patt, indent + "  ");
+    w = search_in_place(b, patt, indent + "  ");
+    b.undo(n);
     if (w == me) {
       patt = Pattern<SIZE>(n, patt);
       if (DEBUG) std::cout << indent << me << " moving at " << n
@@ -474,4 +514,19 @@ char search(const Board<SIZE> &b, Pattern<SIZE> &via, std::string indent="") {
     return me;
   }
 }
+
+// search() makes the only copy of b that the search needs. On boards whose
+// cellsets take more than one quadword, it also tracks that copy with a
+// Connectivity, so that the winner() check after each move is a union-find
+// lookup rather than a flood fill. On smaller boards the flood fill is the
+// cheaper of the two.
+template<bitpos SIZE>
+char search(const Board<SIZE> &b, Pattern<SIZE> &via, std::string indent="") {
+  Connectivity<SIZE> connectivity;
+  Board<SIZE> board(b);
+  if (SIZE*SIZE > 64) {
+    board.track(&connectivity);
+  }
+  return search_in_place(board, via, indent);
+}
 #endif /* __HEXSEARCH_H__ */
@@ -1,3 +1,5 @@
+#include <random>
+#include <sstream>
 #include "board.h"
 #include "search.h"
 #include "gtest/gtest.h"
@@ -74,3 +76,66 @@ TEST(TreeSearch, BoardSize4) {
   EXPECT_EQ('X', winner);
   EXPECT_EQ(Board<4>::cellSet::make({6, 7, 13, 14}), patt.cells());
 }
+
+// referenceMinimumFork is the original exhaustive minimum_fork(): it builds
+// every subset of the tines as a Pattern, and keeps the first cheapest solid
+// one.
+template<bitpos SIZE>
+Pattern<SIZE> referenceMinimumFork(const std::vector< Pattern<SIZE> > &tines) {
+  Pattern<SIZE> cheapest_fork(tines);
+  int cheapest_cost = cheapest_fork.cost();
+  for (int subset = 3; subset < (1 << tines.size()); ++subset) {
+    Pattern<SIZE> subset_fork({});
+    for (int tine = 0; tine < tines.size(); ++tine) {
+      if (((1 << tine) & subset) != 0) {
+        subset_fork.add_subpattern(tines[tine]);
+      }
+    }
+    if (subset_fork.is_solid() && subset_fork.cost() < cheapest_cost) {
+      cheapest_cost = subset_fork.cost();
+      cheapest_fork = subset_fork;
+    }
+  }
+  return cheapest_fork;
+}
+
+TEST(TreeSearch, MinimumFork) {
+  std::minstd_rand generator;
+  std::uniform_int_distribution<int> cell(0, 15), shape(0, 3), count(2, 9);
+  int tested = 0;
+  for (int round = 0; round < 300; ++round) {
+    // Tines are single threats, or threats that rely on one or two others.
+    std::vector< Pattern<4> > tines;
+    for (int n = count(generator); n > 0; --n) {
+      switch (shape(generator)) {
+      case 0:
+      case 1:
+        tines.push_back(Pattern<4>(cell(generator)));
+        break;
+      case 2:
+        tines.push_back(Pattern<4>(cell(generator),
+                                   Pattern<4>(cell(generator))));
+        break;
+      default:
+        tines.push_back(Pattern<4>(cell(generator), Pattern<4>{
+              Pattern<4>(cell(generator)), Pattern<4>(cell(generator))}));
+        break;
+      }
+    }
+    Pattern<4> fork(tines);
+    if (!fork.is_solid()) {
+      continue;
+    }
+    ++tested;
+
+    Pattern<4> want = referenceMinimumFork(tines);
+    Pattern<4> got = fork.minimum_fork();
+    std::ostringstream wantText, gotText;
+    wantText << want;
+    gotText << got;
+    EXPECT_EQ(wantText.str(), gotText.str());
+    EXPECT_EQ(want.cost(), got.cost());
+    EXPECT_EQ(want.cells(), got.cells());
+  }
+  EXPECT_LT(100, tested);
+}
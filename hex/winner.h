@@ -1,3 +1,5 @@
+#ifndef __HEXWINNER_H__
+#define __HEXWINNER_H__ 1
 // "board.h" should be inluded before this file is included.
 
 
@@ -11,6 +13,9 @@
 // the return value will reflect any win found.
 template<bitpos N>
 char Board<N>::winner(char testFor) const {
+  if (tracker != nullptr) {
+    return tracker->winner(testFor);
+  }
   if (testFor != 'O' && verticalHasWon()) {
     return 'X';
   }
@@ -42,12 +47,10 @@ bool Board<N>::horizontalHasWon() const {
   return isConnected(leftColumn(), horizontalCells(), rightColumn());
 }
 
-template<bitpos N>
-bool Board<N>::isConnected(cellset<N> start, cellset<N> owned, cellset<N> stop){
-  typedef cellset<N> Set;
-  constexpr Set l = ~Board<N>::leftColumn();
-  constexpr Set r = ~Board<N>::rightColumn();
-
+// floodConnects() is the body of Board<N>::isConnected(). Set is cellset<N>,
+// or another type providing the same operations (see flood_set in cellset.h).
+template<class Set>
+bool floodConnects(Set start, Set owned, Set stop) {
   Set startGroup = owned & start;
   Set stopGroup = owned & stop;
 
@@ -63,23 +66,50 @@ bool Board<N>::isConnected(cellset<N> start, cellset<N> owned, cellset<N> stop){
     Set startNeighbors = startGroup.fast_neighbors();
     Set stopNeighbors = stopGroup.fast_neighbors();
 
-    Set newStartGroup = (startNeighbors & owned) | startGroup;
-    Set newStopGroup = (stopNeighbors & owned) | stopGroup;
-
-    if (newStartGroup == startGroup && newStopGroup == stopGroup) {
+    bool grew = startGroup.union_changed(startNeighbors & owned);
+    grew |= stopGroup.union_changed(stopNeighbors & owned);
+    if (!grew) {
       // No progress was made.
       return false;
     }
 
     // If flood from start overlaps flood from stop, there is a connection.
-    if ((newStartGroup & newStopGroup).any()) {
+    if (startGroup.intersects(stopGroup)) {
       return true;
     }
+  }
+}
 
-    startGroup = newStartGroup;
-    stopGroup = newStopGroup;
+#ifdef QUADSET_AVX2
+// For two-quadword cellvecs, floodConnects() keeps the start and stop groups
+// in the two halves of one cellvec_pair, and grows both at once.
+template<bitpos SIZE>
+typename std::enable_if<(SIZE*SIZE+63) / 64 == 2, bool>::type
+floodConnects(cellvec<SIZE> start, cellvec<SIZE> owned, cellvec<SIZE> stop) {
+  typedef cellvec_pair<SIZE> Pair;
+  if ((owned & start).none() || (owned & stop).none()) {
+    return false;
+  }
+  const Pair ownedPair = Pair::make(owned, owned);
+  Pair groups = Pair::make(start, stop) & ownedPair;
+  for (;;) {
+    if (!groups.union_changed(groups.fast_neighbors() & ownedPair)) {
+      // No progress was made.
+      return false;
+    }
+    if (groups.halves_intersect()) {
+      return true;
+    }
   }
 }
+#endif
+
+template<bitpos N>
+bool Board<N>::isConnected(cellset<N> start, cellset<N> owned, cellset<N> stop){
+  typedef flood_set<N> Flood;
+  return floodConnects(
+      Flood::load(start), Flood::load(owned), Flood::load(stop));
+}
 
 // virtualWinner() returns 'X', 'O', or '?', depending on whether the game has
 // been won or not, and by whom (vertical == 'X', horizontal == 'O').
@@ -124,17 +154,12 @@ bool Board<N>::horizontalHasVirtualConnection() const {
       leftColumn(), horizontalCells(), rightColumn(), emptyCells());
 }
 
-template<bitpos N>
-bool Board<N>::isVirtuallyConnected(
-    cellset<N> start,
-    cellset<N> owned,
-    cellset<N> stop,
-    cellset<N> vacant
-) {
-  typedef cellset<N> Set;
-  constexpr Set l = ~Board<N>::leftColumn();
-  constexpr Set r = ~Board<N>::rightColumn();
-
+// floodVirtuallyConnects() is the body of Board<N>::isVirtuallyConnected().
+// Set is as for floodConnects(). It is cloned for CPUs with and without POPCNT
+// (see BITOPS_CLONES in bitops.h), for the count that ends the flood.
+template<class Set>
+BITOPS_CLONES
+bool floodVirtuallyConnects(Set start, Set owned, Set stop, Set vacant) {
   Set startGroup = owned & start;
   Set stopGroup = owned & stop;
 
@@ -148,23 +173,61 @@ bool Board<N>::isVirtuallyConnected(
   // set changes.
   for (;;) {
     Set startNeighbors = startGroup.fast_neighbors();
-    Set newStartGroup = (startNeighbors & owned) | startGroup;
-
     Set stopNeighbors = stopGroup.fast_neighbors();
-    Set newStopGroup = (stopNeighbors & owned) | stopGroup;
 
-    if (newStartGroup == startGroup && newStopGroup == stopGroup) {
-      // No progress was made.
-      auto commonEmptyNeighbors = startNeighbors & stopNeighbors & vacant;
-      return commonEmptyNeighbors.any() && commonEmptyNeighbors.count() > 1;
+    bool grew = startGroup.union_changed(startNeighbors & owned);
+    grew |= stopGroup.union_changed(stopNeighbors & owned);
+    if (!grew) {
+      // No progress was made. There is a virtual connection if the groups
+      // have two or more empty neighbors in common.
+      return (startNeighbors & stopNeighbors & vacant).count_at_least(2);
     }
 
     // If flood from start overlaps flood from stop, there is a connection.
-    if ((newStartGroup & newStopGroup).any()) {
+    if (startGroup.intersects(stopGroup)) {
       return true;
     }
+  }
+}
 
-    startGroup = newStartGroup;
-    stopGroup = newStopGroup;
+#ifdef QUADSET_AVX2
+// For two-quadword cellvecs, floodVirtuallyConnects() grows both groups at
+// once, as floodConnects() does.
+template<bitpos SIZE>
+BITOPS_CLONES
+typename std::enable_if<(SIZE*SIZE+63) / 64 == 2, bool>::type
+floodVirtuallyConnects(cellvec<SIZE> start, cellvec<SIZE> owned,
+                       cellvec<SIZE> stop, cellvec<SIZE> vacant) {
+  typedef cellvec_pair<SIZE> Pair;
+  if ((owned & start).none() || (owned & stop).none()) {
+    return false;
   }
+  const Pair ownedPair = Pair::make(owned, owned);
+  Pair groups = Pair::make(start, stop) & ownedPair;
+  for (;;) {
+    const Pair neighbors = groups.fast_neighbors();
+    if (!groups.union_changed(neighbors & ownedPair)) {
+      // No progress was made. There is a virtual connection if the groups
+      // have two or more empty neighbors in common.
+      return (neighbors.first() & neighbors.second() & vacant)
+          .count_at_least(2);
+    }
+    if (groups.halves_intersect()) {
+      return true;
+    }
+  }
+}
+#endif
+
+template<bitpos N>
+bool Board<N>::isVirtuallyConnected(
+    cellset<N> start,
+    cellset<N> owned,
+    cellset<N> stop,
+    cellset<N> vacant
+) {
+  typedef flood_set<N> Flood;
+  return floodVirtuallyConnects(Flood::load(start), Flood::load(owned),
+                                Flood::load(stop), Flood::load(vacant));
 }
+#endif /* __HEXWINNER_H__ */
@@ -1,5 +1,12 @@
+#include <random>
 #include "board.h"
 #include "winner.h"
+#include "anyboard.h"
+#include "positionrank.h"
+#include "paddedboard.h"
+#include "randomgame.h"
+#include "cellset_lanes.h"
+#include "cellset_span.h"
 #include "../benchmark.h"
 
 template<bitpos N>
@@ -219,6 +226,420 @@ std::vector< winnerTest<8> > t8(std::initializer_list< winnerTest<8> >{
                           )")},
 });
 
+std::vector< winnerTest<11> > t11(std::initializer_list< winnerTest<11> >{
+    {'?', '?', Board<11>(R"(
+      - - O - - - - - - X -
+       - - X - X - O - X - O
+        O - - - X X O - - X -
+         X O - - - - O O - X O
+          X - O O - X - X - - O
+           - - - - - - O X - - -
+            - - - O X - - X X - -
+             X - - - - O - - - - O
+              - - X - - - O O - O -
+               - - - - X - - O X X -
+                - - - - - - O - X - -
+                 )")},
+    {'?', '?', Board<11>(R"(
+      O O - - X X - - O X -
+       O X O - - O - - X X X
+        - - - O X X X - X - X
+         - - - O X X - - - - -
+          - X X X X X - O O - O
+           - O - X O O X O O X -
+            X - X O - X - - - - -
+             - - X X O X - O X O -
+              X - - - O - - - - - X
+               - X - O O - - X O O O
+                O O O O - O - O X O -
+                 )")},
+    {'?', '?', Board<11>(R"(
+      X X O X X X - X X - O
+       X X O O O O X X O X -
+        O - X X O O O - O X X
+         X X - - X - - - - O X
+          O O O O O O X O - O -
+           O - X X O O - X - - O
+            - - - O O - O - X X O
+             - - O - - O - X X - -
+              X O O O X X X O O O O
+               - X X X X - O X - X X
+                - X - - - X O O X X O
+                 )")},
+    {'O', 'O', Board<11>(R"(
+      O X O - X X O O O X X
+       X O X - X X O O X X O
+        - X X O O O - O O X O
+         O X O X - X O O X X O
+          O O X X - X O O - O X
+           O X X X X O X O X O X
+            - X O - O O O O O X X
+             X O O O X X X O O X X
+              O - X X O O X X X O O
+               O O O X X X O X X O X
+                - O - O X X O X O X X
+                 )")},
+});
+
+std::vector< winnerTest<13> > t13(std::initializer_list< winnerTest<13> >{
+    {'?', '?', Board<13>(R"(
+      - X O - - - X - - - O X O
+       X - X - - - X - - - - - -
+        X - - X - O - - - - O - -
+         X O - O - - - - - X - - -
+          - X - - - - - - X O - - X
+           - - - X O - X - - - - O -
+            X X - - X - X O O O - - X
+             - - - - - O - X O O - X O
+              O O O - - - - - - - - - X
+               O O - O O - - - - X X - -
+                - X O O - - - - X O - - -
+                 - O X - - - - - - - X - -
+                  O - - - - - - O - - - X -
+                   )")},
+    {'?', '?', Board<13>(R"(
+      X - X X O - - - O - - - -
+       - - X - O O - X X O X X -
+        X - O O O - - - X X - X O
+         O X - O - O X O - O - O -
+          - - - - - O - X X O - X -
+           X - O O - - O X O - - - -
+            X - - - O X O X X X O O -
+             - O - X X X O X - O X O X
+              - O X - - - - X O - X X O
+               O - O - O - - X X X X - O
+                - O X X O O - - O - - O -
+                 - O X - X O O X X - - X -
+                  - X O - X - O - - - - - -
+                   )")},
+    {'?', '?', Board<13>(R"(
+      - - - X O X - X X - X - O
+       O O X X - - O O X - O - X
+        O - O X O X X X - X X X -
+         O X X X X O - O O - - X O
+          X - O - - O O O O X O X X
+           - - - - O X O - O X - - X
+            O X - O - O X O - O O - X
+             - O - X X - - - - - - O O
+              X X O X - O - O O O X O X
+               - O - X X - - X X X X X O
+                O - O O O X O O O X O O O
+                 O - X X O X - - O X X X X
+                  O O O - X X X X O - X O X
+                   )")},
+    {'O', 'O', Board<13>(R"(
+      - X X X X O O O - O O O X
+       - O X X X X O O X O X O O
+        O O O O X O X O O - X O O
+         X - X X X O X - O O X O X
+          X O O O O O X X O O O X X
+           O O X - O O O O O X X O X
+            O O O O O X X X O O - X X
+             O O X - X O O X X O O X X
+              - - X X X X O O - O X O X
+               X X O O O X - X X X O X X
+                X - X X X O X X O - O X X
+                 X X X X X O X O X X O X X
+                  O O X O O O - X O O X X O
+                   )")},
+});
+
+std::vector< winnerTest<14> > t14(std::initializer_list< winnerTest<14> >{
+    {'?', 'X', Board<14>(R"(
+      - - - - - - X - - - - - - -
+       - - - - - - X - - - - - - -
+        - - - - - - X - - - - - - -
+         - - - O - - X - - - - - - -
+          - - - - - - X - - - - - - -
+           - - - - - - X - - - - - - -
+            - - - - - - X - - - - - - -
+             - - - - O - - - - - - - - -
+              - - - - - X - - - - - - - -
+               - - - - - X - - - - - - - -
+                - - - - - X - - - - O - - -
+                 - - - - - X - - - - - - - -
+                  - - - - - X - - - - - - - -
+                   - - - - - X - - - - - - - -
+                    )")},
+    {'X', 'X', Board<14>(R"(
+      O - - - - - X - - - - - - -
+       - - - - - - X - - - - - - -
+        - - - - - - X - - - - - - -
+         - - - O - - X - - - - - - -
+          - - - - - - X - - - - - - -
+           - - - - - - X - - - - - - -
+            - - - - - - X - - - - - - -
+             - - - - - O X - - - - - - -
+              - - - - - X - - - - - - - -
+               - - - - - X - - - - - - - -
+                - - - - - X - - - - O - - -
+                 - - - - - X - - - - - - - -
+                  - - - - - X - - - - - - - -
+                   - - - - - X - - - - - - - -
+                    )")},
+});
+
+std::vector< winnerTest<15> > t15(std::initializer_list< winnerTest<15> >{
+    {'O', 'O', Board<15>(R"(
+      - - - - - - - - - - - - - - -
+       - X - - - - - - - - - - - - -
+        - - X - - - - - - - - - - - -
+         - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - -
+             O O O O O O O O O O O O O O O
+              - - - - - - - - - - - - - - -
+               - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - -
+                   - - - - X - - - - - - - - - -
+                    - - - - - - - - - - - - - - -
+                     )")},
+    {'?', '?', Board<15>(R"(
+      - - - - - - - - - - - - - - -
+       - X - - - - - - - - - - - - -
+        - - X - - - - - - - - - - - -
+         - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - -
+             O O O O O O O O O O X O O O O
+              - - - - - - - - - - - - - - -
+               - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - -
+                   - - - - X - - - - - - - - - -
+                    - - - - - - - - - - - - - - -
+                     )")},
+    {'?', 'O', Board<15>(R"(
+      - - - - - - - - - - - - - - -
+       - X - - - - - - - - - - - - -
+        - - X - - - - - - - - - - - -
+         - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - -
+             O O O O O O O O O O - O O O O
+              - - - - - - - - - - O - - - -
+               - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - -
+                   - - - - X - - - - - - - - - -
+                    - - - - - - - - - - - - - - -
+                     )")},
+});
+
+std::vector< winnerTest<16> > t16(std::initializer_list< winnerTest<16> >{
+    {'?', '?', Board<16>(R"(
+      - - - - - - - - - - - - - - - -
+       - - - - - - - - - - - - - - - -
+        - - - - - - - - - - - - - - - -
+         - - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - - -
+             - - - - - - - - - - - - - - - -
+              - - - - - - - - - - - - - - - -
+               - - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - - -
+                   - - - - - - - - - - - - - - - -
+                    - - - - - - - - - - - - - - - -
+                     - - - - - - - - - - - - - - - -
+                      )")},
+    {'X', 'X', Board<16>(R"(
+      X - - - - - - - - - - - - - - -
+       X X X X X X X X X X X X X X X X
+        - - - - - - - - - - - - - - - X
+         X X X X X X X X X X X X X X X X
+          X - - - - - - - - - - - - - - -
+           X X X X X X X X X X X X X X X X
+            - - - - - - - - - - - - - - - X
+             X X X X X X X X X X X X X X X X
+              X - - - - - - - - - - - - - - -
+               X X X X X X X X X X X X X X X X
+                - - - - - - - - - - - - - - - X
+                 X X X X X X X X X X X X X X X X
+                  X - - - - - - - - - - - - - - -
+                   X X X X X X X X X X X X X X X X
+                    - - - - - - - - - - - - - - - X
+                     X X X X X X X X X X X X X X X X
+                      )")},
+    {'?', 'X', Board<16>(R"(
+      X - - - - - - - - - - - - - - -
+       X X X X X X X X X X X X X X X X
+        - - - - - - - - - - - - - - - X
+         X X X X X X X X X X X X X X X X
+          X - - - - - - - - - - - - - - -
+           X X X X X X X X X X X X X X X X
+            - - - - - - - - - - - - - - - X
+             X X X X X X X X X X X X X X X X
+              X - - - - - - - - - - - - - - -
+               X X X X X X X X - X X X X X X X
+                - - - - - - - - - - - - - - - X
+                 X X X X X X X X X X X X X X X X
+                  X - - - - - - - - - - - - - - -
+                   X X X X X X X X X X X X X X X X
+                    - - - - - - - - - - - - - - - X
+                     X X X X X X X X X X X X X X X X
+                      )")},
+});
+
+std::vector< winnerTest<17> > t17(std::initializer_list< winnerTest<17> >{
+    {'X', 'X', Board<17>(R"(
+      O - - - - - - - X - - - - - - - -
+       - - - - - - - - X - - - - - - - -
+        - - - - - - - - X - - - - - - - -
+         - - - - - - - - X - - - - - - - -
+          - - - - - - - - X - - - - - - - -
+           - - - - - - - - X - - - - - - - -
+            - - - - - - - - X - - - - - - - -
+             - - - - - - - - X - - - - - - - -
+              - - - - - - - - X - - - - - - - -
+               - - - - - - - - X - - - - - - - -
+                - - - - - - - - X - - - - - - - -
+                 - - - - - - - - X - - - - - - - -
+                  - - - - - - - - X - - - - - - - -
+                   - - - - - - - - X - - - - - - - -
+                    - - - - - - - - X - - - - - - - -
+                     - - - - - - - - X - - - - - - - -
+                      - - - - - - - - X - - - - - - - O
+                       )")},
+    {'?', '?', Board<17>(R"(
+      - - - - - - - - X - - - - - - - -
+       - - - - - - - - X - - - - - - - -
+        - - - - - - - - X - - - - - - - -
+         - - - - - - - - X - - - - - - - -
+          - - - - - - - - X - - - - - - - -
+           - - - - - - - - X - - - - - - - -
+            - - - - - - - - X - - - - - - - -
+             - - - - - - - - X - - - - - - - -
+              - - - - - - - - X - - - - - - - -
+               - - - - - - - - X - - - - - - - -
+                - - - - - - - - X - - - - - - - -
+                 - - - - - - - - X - - - - - - - -
+                  - - - - - - - O O - - - - - - - -
+                   - - - - - - - - X - - - - - - - -
+                    - - - - - - - - X - - - - - - - -
+                     - - - - - - - - X - - - - - - - -
+                      - - - - - - - - X - - - - - - - -
+                       )")},
+});
+
+std::vector< winnerTest<18> > t18(std::initializer_list< winnerTest<18> >{
+    {'O', 'O', Board<18>(R"(
+      O O - O O O - O O O - O O O - O O O
+       - O - O - O - O - O - O - O - O - O
+        - O - O - O - O - O - O - O - O - O
+         - O - O - O - O - O - O - O - O - O
+          - O - O - O - O - O - O - O - O - O
+           - O - O - O - O - O - O - O - O - O
+            - O - O - O - O - O - O - O - O - O
+             - O - O - O - O - O - O - O - O - O
+              - O - O - O - O - O - O - O - O - O
+               - O - O - O - O - O - O - O - O - O
+                - O - O - O - O - O - O - O - O - O
+                 - O - O - O - O - O - O - O - O - O
+                  - O - O - O - O - O - O - O - O - O
+                   - O - O - O - O - O - O - O - O - O
+                    - O - O - O - O - O - O - O - O - O
+                     - O - O - O - O - O - O - O - O - O
+                      - O - O - O - O - O - O - O - O - O
+                       - O O O - O O O - O O O - O O O - O
+                        )")},
+    {'?', 'O', Board<18>(R"(
+      O O - O O O - O O O - O O O - O O O
+       - O - O - O - O - O - O - O - O - O
+        - O - O - O - O - O - O - O - O - O
+         - O - O - O - O - O - O - O - O - O
+          - O - O - O - O - O - O - O - O - O
+           - O - O - O - O - O - O - O - O - O
+            - O - O - O - O - O - O - O - O - O
+             - O - O - O - O - O - O - O - O - O
+              - O - O - O - O - O - O - O - O - O
+               - O - O - - - O - O - O - O - O - O
+                - O - O - O - O - O - O - O - O - O
+                 - O - O - O - O - O - O - O - O - O
+                  - O - O - O - O - O - O - O - O - O
+                   - O - O - O - O - O - O - O - O - O
+                    - O - O - O - O - O - O - O - O - O
+                     - O - O - O - O - O - O - O - O - O
+                      - O - O - O - O - O - O - O - O - O
+                       - O O O - O O O - O O O - O O O - O
+                        )")},
+});
+
+std::vector< winnerTest<19> > t19(std::initializer_list< winnerTest<19> >{
+    {'?', '?', Board<19>(R"(
+      - - - - - - - - - X - - - - - - - - -
+       - - - - - - - - - X - - - - - - - - -
+        O - - - - - - - - - - - - - - - - - -
+         - - - - - - - - - X - - - - - - - - -
+          - - - - - - - - - X - - - - - - - - -
+           O - - - - - - - - - - - - - - - - - -
+            - - - - - - - - - X - - - - - - - - -
+             - - - - - - - - - X - - - - - - - - -
+              - - - - - - - - - - - - - - - - - - -
+               - - - - - - - - - X - - - - - - - - -
+                - - - - - - - - - X - - - - - - - - -
+                 - - - - - - - - - - - - - - - - - - -
+                  - - - - - - - - - X - - - - - - - - -
+                   - - - - - - - - - X - - - - - - - - -
+                    - - - - - - - - - - - - - - - - - - -
+                     - - - - - - - - - X - - - - - - - - -
+                      - - - - - - - - - X - - - - - - - - -
+                       - - - - - - - - - - - - - - - - - - -
+                        - - - - - - - - - X - - - - - - - - -
+                         )")},
+    {'X', 'X', Board<19>(R"(
+      - - - - - - - - - X O - - - - - - - -
+       - - - - - - - - - X O - - - - - - - -
+        - - - - - - - - - X O - - - - - - - -
+         - - - - - - - - - X O - - - - - - - -
+          - - - - - - - - - X O - - - - - - - -
+           - - - - - - - - - X O - - - - - - - -
+            - - - - - - - - - X O - - - - - - - -
+             - - - - - - - - - X O - - - - - - - -
+              - - - - - - - - - X O - - - - - - - -
+               - - - - - - - - - X O - - - - - - - -
+                - - - - - - - - - X O - - - - - - - -
+                 - - - - - - - - - X O - - - - - - - -
+                  - - - - - - - - - X O - - - - - - - -
+                   - - - - - - - - - X O - - - - - - - -
+                    - - - - - - - - - X O - - - - - - - -
+                     - - - - - - - - - X O - - - - - - - -
+                      - - - - - - - - - X O - - - - - - - -
+                       - - - - - - - - - X O - - - - - - - -
+                        - - - - - - - - - X O - - - - - - - -
+                         )")},
+    {'?', '?', Board<19>(R"(
+      - - - - - - - - - - - - - - - - - - -
+       - - - - - - - - - - - - - - - - - - -
+        - - - - - - - - - - - - - - - - - - -
+         - - - - - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - - - - - -
+             - - - - - - - - - - - - - - - - - - -
+              - - - - - - - - - - - - - - - - - - -
+               - - - - - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - - - - - -
+                   - - - - - - - - - - - - - - - - - - -
+                    - - - - - - - - - - - - - - - - - - -
+                     - - - - - - - - - - - - - - - - - - -
+                      - - - - - - - - - - - - - - - - - - -
+                       - - - - - - - - - - - - - - - - - - -
+                        - - - - - - - - - - - - - - - - - - -
+                         )")},
+});
+
 int globalSum = 0;
 
 template<bitpos N>
@@ -264,8 +685,568 @@ void Benchmark_SimpleVirtualWinner(Benchmark &b) {
   }
 }
 
+// The 11x11 and 13x13 benchmarks use random mid- and late-game positions on
+// the two board sizes most often played. Their cellsets need two and three
+// quadwords, respectively.
+void Benchmark_Winner11x11(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runWinnerTests(t11);
+  }
+}
+
+void Benchmark_SimpleVirtualWinner11x11(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runSimpleVirtualWinnerTests(t11);
+  }
+}
+
+void Benchmark_Winner13x13(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runWinnerTests(t13);
+  }
+}
+
+void Benchmark_SimpleVirtualWinner13x13(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runSimpleVirtualWinnerTests(t13);
+  }
+}
+
+// Benchmark_AnyBoardWinner13x13 tests the same positions as
+// Benchmark_Winner13x13, through AnyBoard's dispatch table.
+void Benchmark_AnyBoardWinner13x13(Benchmark &b) {
+  static std::vector<AnyBoard> boards;
+  if (boards.empty()) {
+    for (auto &t : t13) {
+      boards.push_back(AnyBoard(t.board));
+    }
+  }
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (size_t j = 0; j < boards.size(); ++j) {
+      if (boards[j].winner('?') == t13[j].winner) {
+        ++globalSum;
+      }
+    }
+  }
+}
+
+// Benchmark_WinnerLanes13x13 tests the same 13x13 positions as
+// Benchmark_Winner13x13, but all four at once, with one cellset_lanes flood
+// fill per player.
+void Benchmark_WinnerLanes13x13(Benchmark &b) {
+  typedef cellset_lanes<13,4> Lanes;
+  Lanes vert = Lanes::make();
+  Lanes horz = Lanes::make();
+  for (int i = 0; i < 4; ++i) {
+    vert.set_lane(i, t13[i].board.verticalCells());
+    horz.set_lane(i, t13[i].board.horizontalCells());
+  }
+  const Lanes top = Lanes::broadcast(Board<13>::topRow());
+  const Lanes bottom = Lanes::broadcast(Board<13>::bottomRow());
+  const Lanes left = Lanes::broadcast(Board<13>::leftColumn());
+  const Lanes right = Lanes::broadcast(Board<13>::rightColumn());
+
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    uint32_t xWins = Lanes::connected(top, vert, bottom);
+    uint32_t oWins = Lanes::connected(left, horz, right);
+    globalSum += countBits(xWins | oWins);
+  }
+}
+
+// The FourQuads benchmarks use board sizes 14..16, whose cellsets need four
+// quadwords. Comparing them against the benchmarks above (whose boards all
+// fit in a single quadword) shows how the per-word cost grows.
+void Benchmark_WinnerFourQuads(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runWinnerTests(t14);
+    runWinnerTests(t15);
+    runWinnerTests(t16);
+  }
+}
+
+void Benchmark_SimpleVirtualWinnerFourQuads(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runSimpleVirtualWinnerTests(t14);
+    runSimpleVirtualWinnerTests(t15);
+    runSimpleVirtualWinnerTests(t16);
+  }
+}
+
+// The SixQuads benchmarks use board sizes 17..19, whose cellsets need five or
+// six quadwords, and so are handled by the generic qset template.
+void Benchmark_WinnerSixQuads(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runWinnerTests(t17);
+    runWinnerTests(t18);
+    runWinnerTests(t19);
+  }
+}
+
+void Benchmark_SimpleVirtualWinnerSixQuads(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runSimpleVirtualWinnerTests(t17);
+    runSimpleVirtualWinnerTests(t18);
+    runSimpleVirtualWinnerTests(t19);
+  }
+}
+
+// runtimeFastNeighbors is cellset<N>::fast_neighbors() written with
+// runtime-distance shifts, as it was before shl<n>() and shr<n>() existed.
+template<bitpos N>
+cellset<N> runtimeFastNeighbors(cellset<N> s) {
+  const auto l = cellset<N>::left().fast_not();
+  const auto r = cellset<N>::right().fast_not();
+  return ( (s >> N)
+         | (((s >> (N - 1)) | s.fast_lsh(1)) & l)
+         | ((s.fast_lsh(N - 1) | (s >> 1)) & r)
+         | s.fast_lsh(N)
+         );
+}
+
+// Grows a group from each corner cell of every test board, through the
+// board's empty cells, for eight steps.
+template<bitpos N, bool constantShifts>
+void runNeighbors(const std::vector< winnerTest<N> > &tests) {
+  for (auto &t : tests) {
+    const cellset<N> empty = t.board.emptyCells();
+    cellset<N> group = cellset<N>::make({0, N - 1, N*N - N, N*N - 1});
+    for (int step = 0; step < 8; ++step) {
+      group |= (constantShifts ? group.fast_neighbors()
+                               : runtimeFastNeighbors(group)) & empty;
+    }
+    globalSum += group.count();
+  }
+}
+
+void Benchmark_RuntimeShiftNeighbors13x13(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runNeighbors<13, false>(t13);
+  }
+}
+
+void Benchmark_ConstantShiftNeighbors13x13(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runNeighbors<13, true>(t13);
+  }
+}
+
+void Benchmark_RuntimeShiftNeighbors19x19(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runNeighbors<19, false>(t19);
+  }
+}
+
+void Benchmark_ConstantShiftNeighbors19x19(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    runNeighbors<19, true>(t19);
+  }
+}
+
+// Benchmark_StateString13x13 and Benchmark_Hash13x13 compare two ways of
+// keying a cache by board position: stringifying it, or hashing it.
+void Benchmark_StateString13x13(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (auto &t : t13) {
+      globalSum += t.board.stateString().size();
+    }
+  }
+}
+
+void Benchmark_Hash13x13(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (auto &t : t13) {
+      globalSum += t.board.hash() & 1;
+    }
+  }
+}
+
+// Benchmark_CanonicalHash13x13 keys the same boards by canonicalHash(), so
+// that symmetric boards share a cache entry.
+void Benchmark_CanonicalHash13x13(Benchmark &b) {
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (auto &t : t13) {
+      globalSum += t.board.canonicalHash() & 1;
+    }
+  }
+}
+
+// Benchmark_PlayWinner13x13 and Benchmark_PlayTrackedWinner13x13 play one
+// random game of 169 moves on a 13x13 board per iteration, calling winner()
+// after each move, and then undo every move, as a search does. The first
+// floods the board for each winner() call; the second tracks the board with
+// a Connectivity.
+const std::vector<int> &game13x13() {
+  static const std::vector<int> cells = randomGame<13>(1);
+  return cells;
+}
+
+void playAndUndo(Board<13> &board, const std::vector<int> &cells) {
+  for (int cell : cells) {
+    globalSum += board.go(cell).winner(board.opponent());
+  }
+  for (auto it = cells.rbegin(); it != cells.rend(); ++it) {
+    board.undo(*it);
+  }
+}
+
+void Benchmark_PlayWinner13x13(Benchmark &b) {
+  const std::vector<int> &cells = game13x13();
+  Board<13> board;
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    playAndUndo(board, cells);
+  }
+}
+
+void Benchmark_PlayTrackedWinner13x13(Benchmark &b) {
+  const std::vector<int> &cells = game13x13();
+  Connectivity<13> connectivity;
+  Board<13> board;
+  board.track(&connectivity);
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    playAndUndo(board, cells);
+  }
+}
+
+// The parse and format benchmarks work on a corpus of 1024 random 13x13
+// state strings, one per line; ns/op is per board.
+const std::string &corpus13x13() {
+  static std::string corpus;
+  if (corpus.empty()) {
+    std::minstd_rand generator;
+    for (int i = 0; i < 1024; ++i) {
+      Board<13> board;
+      for (bitpos cell = 0; cell < 13*13; ++cell) {
+        if (generator() % 3 == 0) {
+          board.go(cell);
+        }
+      }
+      corpus += board.stateString() + "\n";
+    }
+  }
+  return corpus;
+}
+
+// Benchmark_ParseString13x13 constructs each board with Board(content),
+// from a std::string of its cells.
+void Benchmark_ParseString13x13(Benchmark &b) {
+  const std::string &corpus = corpus13x13();
+  const size_t line = Board<13>::stateLength + 1;
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    const size_t at = (i % 1024) * line;
+    globalSum += Board<13>(corpus.substr(at + 2, 13*13)).hash() & 1;
+  }
+}
+
+void Benchmark_ParseStates13x13(Benchmark &b) {
+  const std::string &corpus = corpus13x13();
+  static std::vector< Board<13> > boards(1024);
+  globalSum = 0;
+  for (int i = 0; i < b.N; i += 1024) {
+    globalSum += Board<13>::parseStates(corpus.data(), corpus.size(),
+                                        boards.data());
+  }
+}
+
+void Benchmark_FormatState13x13(Benchmark &b) {
+  static std::vector< Board<13> > boards(1024);
+  const std::string &corpus = corpus13x13();
+  Board<13>::parseStates(corpus.data(), corpus.size(), boards.data());
+  char buffer[Board<13>::stateLength];
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    globalSum += boards[i % 1024].formatState(buffer) + buffer[2 + i % 169];
+  }
+}
+
+// Benchmark_Unpack13x13 reads the same boards from packed records (see
+// Board.pack()), as they would be read from a mapped BoardFile.
+void Benchmark_Unpack13x13(Benchmark &b) {
+  static std::vector<uint64_t> records;
+  if (records.empty()) {
+    std::vector< Board<13> > boards(1024);
+    const std::string &corpus = corpus13x13();
+    Board<13>::parseStates(corpus.data(), corpus.size(), boards.data());
+    records.resize(1024 * Board<13>::recordWords);
+    for (int i = 0; i < 1024; ++i) {
+      boards[i].pack(&records[i * Board<13>::recordWords]);
+    }
+  }
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    const uint64_t *record = &records[(i % 1024) * Board<13>::recordWords];
+    globalSum += Board<13>::unpack(record).hash() & 1;
+  }
+}
+
+// Benchmark_Rank6x6 and Benchmark_Unrank6x6 convert between random legal
+// 6x6 positions and their ranks (see positionrank.h); Benchmark_UnrankCells6x6
+// leaves out making a Board of each position.
+const std::vector<uint64_t> &ranks6x6() {
+  static std::vector<uint64_t> ranks;
+  if (ranks.empty()) {
+    std::minstd_rand generator;
+    std::uniform_int_distribution<uint64_t> dist(0, legalPositions<6>() - 1);
+    for (int i = 0; i < 1024; ++i) {
+      ranks.push_back(dist(generator));
+    }
+  }
+  return ranks;
+}
+
+void Benchmark_Rank6x6(Benchmark &b) {
+  static std::vector< Board<6> > boards;
+  if (boards.empty()) {
+    for (uint64_t rank : ranks6x6()) {
+      boards.push_back(unrankPosition<6>(rank));
+    }
+  }
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    globalSum += rankPosition(boards[i % 1024]);
+  }
+}
+
+void Benchmark_Unrank6x6(Benchmark &b) {
+  const std::vector<uint64_t> &ranks = ranks6x6();
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    globalSum += unrankPosition<6>(ranks[i % 1024]).hash() & 1;
+  }
+}
+
+void Benchmark_UnrankCells6x6(Benchmark &b) {
+  const std::vector<uint64_t> &ranks = ranks6x6();
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    uint64_t x = 0, o = 0;
+    unrankCells<6>(ranks[i % 1024], x, o);
+    globalSum += x ^ o;
+  }
+}
+
+// Benchmark_DenseWinner<N> and Benchmark_PaddedWinner<N> call winner() on
+// the same 64 random mid- and late-game N×N positions, held as Board<N> and
+// as PaddedBoard<N>, to compare the dense cellset layout with the padded one
+// (see cellset_padded.h). They are run for the sizes at which both layouts
+// take the same number of words.
+template<bitpos N>
+const std::vector< Board<N> > &randomGames() {
+  static std::vector< Board<N> > boards;
+  if (boards.empty()) {
+    std::minstd_rand generator(N);
+    std::uniform_int_distribution<int> moves(N*N / 3, N*N);
+    for (int i = 0; i < 64; ++i) {
+      const std::vector<int> cells = randomGame<N>(generator);
+      Board<N> board;
+      for (int j = moves(generator); j > 0; --j) {
+        board.go(cells[j - 1]);
+      }
+      boards.push_back(board);
+    }
+  }
+  return boards;
+}
+
+template<bitpos N>
+void Benchmark_DenseWinner(Benchmark &b) {
+  const std::vector< Board<N> > &boards = randomGames<N>();
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    globalSum += boards[i & 63].winner();
+  }
+}
+
+template<bitpos N>
+void Benchmark_PaddedWinner(Benchmark &b) {
+  static std::vector< PaddedBoard<N> > boards;
+  if (boards.empty()) {
+    for (const Board<N> &board : randomGames<N>()) {
+      boards.push_back(PaddedBoard<N>(board));
+    }
+  }
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    globalSum += boards[i & 63].winner();
+  }
+}
+
+// Benchmark_Symmetries<N> applies rotate180(), transpose(), and
+// anti_transpose() to one random set of cells per iteration, to compare with
+// the cost of a winner() call on a board of the same size.
+template<bitpos N>
+void Benchmark_Symmetries(Benchmark &b) {
+  static std::vector< cellset<N> > sets;
+  if (sets.empty()) {
+    std::minstd_rand generator;
+    std::uniform_int_distribution<int> dist(0, 2);
+    for (int i = 0; i < 64; ++i) {
+      cellset<N> s;
+      for (bitpos cell = 0; cell < N*N; ++cell) {
+        if (dist(generator) == 0) {
+          s.set(cell);
+        }
+      }
+      sets.push_back(s);
+    }
+  }
+  globalSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    const cellset<N> s = sets[i & 63];
+    globalSum += (s.rotate180() ^ s.transpose() ^ s.anti_transpose()).count();
+  }
+}
+
+// The Span benchmarks scan 2^20 13×13 sets, 24 MiB, held in a cellset_span;
+// ns/op is per set. Benchmark_CopyAndMask13x13 does the work of
+// Benchmark_SpanAndMask13x13 by copying each set into a cellset value.
+const size_t spanSize = 1 << 20;
+std::vector<uint64_t> spanWords(spanSize * cellset_span<13>::QUADWORDS);
+std::vector<uint64_t> spanOutput(spanWords.size());
+std::vector<bitpos> spanCounts(spanSize);
+
+cellset_span<13> spanOfRandomSets() {
+  cellset_span<13> span(spanWords.data(), spanSize);
+  if (span[0].none()) {
+    std::minstd_rand generator;
+    std::uniform_int_distribution<int> dist(0, 2);
+    for (size_t i = 0; i < spanSize; ++i) {
+      cellset<13> s;
+      for (bitpos cell = 0; cell < 169; ++cell) {
+        if (dist(generator) == 0) {
+          s.set(cell);
+        }
+      }
+      span.store(i, s | cellset<13>{1});
+    }
+  }
+  return span;
+}
+
+void Benchmark_CopyAndMask13x13(Benchmark &b) {
+  cellset_span<13> span = spanOfRandomSets(), out(spanOutput.data(), spanSize);
+  const cellset<13> mask = cellset<13>::rectangle(2, 2, 9, 9);
+  b.ResetTimer();
+  for (int i = 0; i < b.N; i += spanSize) {
+    const size_t n = std::min(spanSize, size_t(b.N - i));
+    for (size_t j = 0; j < n; ++j) {
+      out.store(j, span[j] & mask);
+    }
+  }
+}
+
+void Benchmark_SpanAndMask13x13(Benchmark &b) {
+  cellset_span<13> span = spanOfRandomSets(), out(spanOutput.data(), spanSize);
+  const cellset<13> mask = cellset<13>::rectangle(2, 2, 9, 9);
+  b.ResetTimer();
+  for (int i = 0; i < b.N; i += spanSize) {
+    const size_t n = std::min(spanSize, size_t(b.N - i));
+    span.subspan(0, n).and_mask(mask, out);
+  }
+}
+
+void Benchmark_SpanCount13x13(Benchmark &b) {
+  cellset_span<13> span = spanOfRandomSets();
+  b.ResetTimer();
+  for (int i = 0; i < b.N; i += spanSize) {
+    span.subspan(0, std::min(spanSize, size_t(b.N - i)))
+        .count(spanCounts.data());
+  }
+}
+
+void Benchmark_SpanTest13x13(Benchmark &b) {
+  cellset_span<13> span = spanOfRandomSets();
+  b.ResetTimer();
+  for (int i = 0; i < b.N; i += spanSize) {
+    span.subspan(0, std::min(spanSize, size_t(b.N - i)))
+        .test(84, spanOutput.data());
+  }
+}
+
 int main() {
   BENCHMARK(Benchmark_Winner);
   BENCHMARK(Benchmark_SimpleVirtualWinner);
+  BENCHMARK(Benchmark_Winner11x11);
+  BENCHMARK(Benchmark_SimpleVirtualWinner11x11);
+  BENCHMARK(Benchmark_Winner13x13);
+  BENCHMARK(Benchmark_SimpleVirtualWinner13x13);
+  BENCHMARK(Benchmark_AnyBoardWinner13x13);
+  BENCHMARK(Benchmark_WinnerLanes13x13);
+  BENCHMARK(Benchmark_WinnerFourQuads);
+  BENCHMARK(Benchmark_SimpleVirtualWinnerFourQuads);
+  BENCHMARK(Benchmark_WinnerSixQuads);
+  BENCHMARK(Benchmark_SimpleVirtualWinnerSixQuads);
+  BENCHMARK(Benchmark_RuntimeShiftNeighbors13x13);
+  BENCHMARK(Benchmark_ConstantShiftNeighbors13x13);
+  BENCHMARK(Benchmark_RuntimeShiftNeighbors19x19);
+  BENCHMARK(Benchmark_ConstantShiftNeighbors19x19);
+  BENCHMARK(Benchmark_StateString13x13);
+  BENCHMARK(Benchmark_Hash13x13);
+  BENCHMARK(Benchmark_CanonicalHash13x13);
+  BENCHMARK(Benchmark_ParseString13x13);
+  BENCHMARK(Benchmark_ParseStates13x13);
+  BENCHMARK(Benchmark_FormatState13x13);
+  BENCHMARK(Benchmark_Unpack13x13);
+  BENCHMARK(Benchmark_Rank6x6);
+  BENCHMARK(Benchmark_Unrank6x6);
+  BENCHMARK(Benchmark_UnrankCells6x6);
+  BENCHMARK(Benchmark_DenseWinner<2>);
+  BENCHMARK(Benchmark_PaddedWinner<2>);
+  BENCHMARK(Benchmark_DenseWinner<3>);
+  BENCHMARK(Benchmark_PaddedWinner<3>);
+  BENCHMARK(Benchmark_DenseWinner<4>);
+  BENCHMARK(Benchmark_PaddedWinner<4>);
+  BENCHMARK(Benchmark_DenseWinner<5>);
+  BENCHMARK(Benchmark_PaddedWinner<5>);
+  BENCHMARK(Benchmark_DenseWinner<6>);
+  BENCHMARK(Benchmark_PaddedWinner<6>);
+  BENCHMARK(Benchmark_DenseWinner<7>);
+  BENCHMARK(Benchmark_PaddedWinner<7>);
+  BENCHMARK(Benchmark_DenseWinner<9>);
+  BENCHMARK(Benchmark_PaddedWinner<9>);
+  BENCHMARK(Benchmark_DenseWinner<10>);
+  BENCHMARK(Benchmark_PaddedWinner<10>);
+  BENCHMARK(Benchmark_DenseWinner<12>);
+  BENCHMARK(Benchmark_PaddedWinner<12>);
+  BENCHMARK(Benchmark_DenseWinner<13>);
+  BENCHMARK(Benchmark_PaddedWinner<13>);
+  BENCHMARK(Benchmark_PlayWinner13x13);
+  BENCHMARK(Benchmark_PlayTrackedWinner13x13);
+  BENCHMARK(Benchmark_CopyAndMask13x13);
+  BENCHMARK(Benchmark_SpanAndMask13x13);
+  BENCHMARK(Benchmark_SpanCount13x13);
+  BENCHMARK(Benchmark_SpanTest13x13);
+  BENCHMARK(Benchmark_Symmetries<1>);
+  BENCHMARK(Benchmark_Symmetries<2>);
+  BENCHMARK(Benchmark_Symmetries<3>);
+  BENCHMARK(Benchmark_Symmetries<4>);
+  BENCHMARK(Benchmark_Symmetries<5>);
+  BENCHMARK(Benchmark_Symmetries<6>);
+  BENCHMARK(Benchmark_Symmetries<7>);
+  BENCHMARK(Benchmark_Symmetries<8>);
+  BENCHMARK(Benchmark_Symmetries<9>);
+  BENCHMARK(Benchmark_Symmetries<10>);
+  BENCHMARK(Benchmark_Symmetries<11>);
+  BENCHMARK(Benchmark_Symmetries<12>);
+  BENCHMARK(Benchmark_Symmetries<13>);
   return 0;
 }
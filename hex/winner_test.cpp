@@ -2,6 +2,8 @@
 #include <vector>
 #include "board.h"
 #include "winner.h"
+#include "paddedboard.h"
+#include "randomgame.h"
 #include "gtest/gtest.h"
 
 
@@ -338,6 +340,302 @@ std::vector< winnerTest<8> > tests8(std::initializer_list< winnerTest<8> >{
                           )")},
 });
 
+std::vector< winnerTest<14> > tests14(std::initializer_list< winnerTest<14> >{
+    {'?', 'X', Board<14>(R"(
+      - - - - - - X - - - - - - -
+       - - - - - - X - - - - - - -
+        - - - - - - X - - - - - - -
+         - - - O - - X - - - - - - -
+          - - - - - - X - - - - - - -
+           - - - - - - X - - - - - - -
+            - - - - - - X - - - - - - -
+             - - - - O - - - - - - - - -
+              - - - - - X - - - - - - - -
+               - - - - - X - - - - - - - -
+                - - - - - X - - - - O - - -
+                 - - - - - X - - - - - - - -
+                  - - - - - X - - - - - - - -
+                   - - - - - X - - - - - - - -
+                    )")},
+    {'X', 'X', Board<14>(R"(
+      O - - - - - X - - - - - - -
+       - - - - - - X - - - - - - -
+        - - - - - - X - - - - - - -
+         - - - O - - X - - - - - - -
+          - - - - - - X - - - - - - -
+           - - - - - - X - - - - - - -
+            - - - - - - X - - - - - - -
+             - - - - - O X - - - - - - -
+              - - - - - X - - - - - - - -
+               - - - - - X - - - - - - - -
+                - - - - - X - - - - O - - -
+                 - - - - - X - - - - - - - -
+                  - - - - - X - - - - - - - -
+                   - - - - - X - - - - - - - -
+                    )")},
+});
+
+std::vector< winnerTest<15> > tests15(std::initializer_list< winnerTest<15> >{
+    {'O', 'O', Board<15>(R"(
+      - - - - - - - - - - - - - - -
+       - X - - - - - - - - - - - - -
+        - - X - - - - - - - - - - - -
+         - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - -
+             O O O O O O O O O O O O O O O
+              - - - - - - - - - - - - - - -
+               - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - -
+                   - - - - X - - - - - - - - - -
+                    - - - - - - - - - - - - - - -
+                     )")},
+    {'?', '?', Board<15>(R"(
+      - - - - - - - - - - - - - - -
+       - X - - - - - - - - - - - - -
+        - - X - - - - - - - - - - - -
+         - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - -
+             O O O O O O O O O O X O O O O
+              - - - - - - - - - - - - - - -
+               - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - -
+                   - - - - X - - - - - - - - - -
+                    - - - - - - - - - - - - - - -
+                     )")},
+    {'?', 'O', Board<15>(R"(
+      - - - - - - - - - - - - - - -
+       - X - - - - - - - - - - - - -
+        - - X - - - - - - - - - - - -
+         - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - -
+             O O O O O O O O O O - O O O O
+              - - - - - - - - - - O - - - -
+               - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - -
+                   - - - - X - - - - - - - - - -
+                    - - - - - - - - - - - - - - -
+                     )")},
+});
+
+std::vector< winnerTest<16> > tests16(std::initializer_list< winnerTest<16> >{
+    {'?', '?', Board<16>(R"(
+      - - - - - - - - - - - - - - - -
+       - - - - - - - - - - - - - - - -
+        - - - - - - - - - - - - - - - -
+         - - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - - -
+             - - - - - - - - - - - - - - - -
+              - - - - - - - - - - - - - - - -
+               - - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - - -
+                   - - - - - - - - - - - - - - - -
+                    - - - - - - - - - - - - - - - -
+                     - - - - - - - - - - - - - - - -
+                      )")},
+    {'X', 'X', Board<16>(R"(
+      X - - - - - - - - - - - - - - -
+       X X X X X X X X X X X X X X X X
+        - - - - - - - - - - - - - - - X
+         X X X X X X X X X X X X X X X X
+          X - - - - - - - - - - - - - - -
+           X X X X X X X X X X X X X X X X
+            - - - - - - - - - - - - - - - X
+             X X X X X X X X X X X X X X X X
+              X - - - - - - - - - - - - - - -
+               X X X X X X X X X X X X X X X X
+                - - - - - - - - - - - - - - - X
+                 X X X X X X X X X X X X X X X X
+                  X - - - - - - - - - - - - - - -
+                   X X X X X X X X X X X X X X X X
+                    - - - - - - - - - - - - - - - X
+                     X X X X X X X X X X X X X X X X
+                      )")},
+    {'?', 'X', Board<16>(R"(
+      X - - - - - - - - - - - - - - -
+       X X X X X X X X X X X X X X X X
+        - - - - - - - - - - - - - - - X
+         X X X X X X X X X X X X X X X X
+          X - - - - - - - - - - - - - - -
+           X X X X X X X X X X X X X X X X
+            - - - - - - - - - - - - - - - X
+             X X X X X X X X X X X X X X X X
+              X - - - - - - - - - - - - - - -
+               X X X X X X X X - X X X X X X X
+                - - - - - - - - - - - - - - - X
+                 X X X X X X X X X X X X X X X X
+                  X - - - - - - - - - - - - - - -
+                   X X X X X X X X X X X X X X X X
+                    - - - - - - - - - - - - - - - X
+                     X X X X X X X X X X X X X X X X
+                      )")},
+});
+
+std::vector< winnerTest<17> > tests17(std::initializer_list< winnerTest<17> >{
+    {'X', 'X', Board<17>(R"(
+      O - - - - - - - X - - - - - - - -
+       - - - - - - - - X - - - - - - - -
+        - - - - - - - - X - - - - - - - -
+         - - - - - - - - X - - - - - - - -
+          - - - - - - - - X - - - - - - - -
+           - - - - - - - - X - - - - - - - -
+            - - - - - - - - X - - - - - - - -
+             - - - - - - - - X - - - - - - - -
+              - - - - - - - - X - - - - - - - -
+               - - - - - - - - X - - - - - - - -
+                - - - - - - - - X - - - - - - - -
+                 - - - - - - - - X - - - - - - - -
+                  - - - - - - - - X - - - - - - - -
+                   - - - - - - - - X - - - - - - - -
+                    - - - - - - - - X - - - - - - - -
+                     - - - - - - - - X - - - - - - - -
+                      - - - - - - - - X - - - - - - - O
+                       )")},
+    {'?', '?', Board<17>(R"(
+      - - - - - - - - X - - - - - - - -
+       - - - - - - - - X - - - - - - - -
+        - - - - - - - - X - - - - - - - -
+         - - - - - - - - X - - - - - - - -
+          - - - - - - - - X - - - - - - - -
+           - - - - - - - - X - - - - - - - -
+            - - - - - - - - X - - - - - - - -
+             - - - - - - - - X - - - - - - - -
+              - - - - - - - - X - - - - - - - -
+               - - - - - - - - X - - - - - - - -
+                - - - - - - - - X - - - - - - - -
+                 - - - - - - - - X - - - - - - - -
+                  - - - - - - - O O - - - - - - - -
+                   - - - - - - - - X - - - - - - - -
+                    - - - - - - - - X - - - - - - - -
+                     - - - - - - - - X - - - - - - - -
+                      - - - - - - - - X - - - - - - - -
+                       )")},
+});
+
+std::vector< winnerTest<18> > tests18(std::initializer_list< winnerTest<18> >{
+    {'O', 'O', Board<18>(R"(
+      O O - O O O - O O O - O O O - O O O
+       - O - O - O - O - O - O - O - O - O
+        - O - O - O - O - O - O - O - O - O
+         - O - O - O - O - O - O - O - O - O
+          - O - O - O - O - O - O - O - O - O
+           - O - O - O - O - O - O - O - O - O
+            - O - O - O - O - O - O - O - O - O
+             - O - O - O - O - O - O - O - O - O
+              - O - O - O - O - O - O - O - O - O
+               - O - O - O - O - O - O - O - O - O
+                - O - O - O - O - O - O - O - O - O
+                 - O - O - O - O - O - O - O - O - O
+                  - O - O - O - O - O - O - O - O - O
+                   - O - O - O - O - O - O - O - O - O
+                    - O - O - O - O - O - O - O - O - O
+                     - O - O - O - O - O - O - O - O - O
+                      - O - O - O - O - O - O - O - O - O
+                       - O O O - O O O - O O O - O O O - O
+                        )")},
+    {'?', 'O', Board<18>(R"(
+      O O - O O O - O O O - O O O - O O O
+       - O - O - O - O - O - O - O - O - O
+        - O - O - O - O - O - O - O - O - O
+         - O - O - O - O - O - O - O - O - O
+          - O - O - O - O - O - O - O - O - O
+           - O - O - O - O - O - O - O - O - O
+            - O - O - O - O - O - O - O - O - O
+             - O - O - O - O - O - O - O - O - O
+              - O - O - O - O - O - O - O - O - O
+               - O - O - - - O - O - O - O - O - O
+                - O - O - O - O - O - O - O - O - O
+                 - O - O - O - O - O - O - O - O - O
+                  - O - O - O - O - O - O - O - O - O
+                   - O - O - O - O - O - O - O - O - O
+                    - O - O - O - O - O - O - O - O - O
+                     - O - O - O - O - O - O - O - O - O
+                      - O - O - O - O - O - O - O - O - O
+                       - O O O - O O O - O O O - O O O - O
+                        )")},
+});
+
+std::vector< winnerTest<19> > tests19(std::initializer_list< winnerTest<19> >{
+    {'?', '?', Board<19>(R"(
+      - - - - - - - - - X - - - - - - - - -
+       - - - - - - - - - X - - - - - - - - -
+        O - - - - - - - - - - - - - - - - - -
+         - - - - - - - - - X - - - - - - - - -
+          - - - - - - - - - X - - - - - - - - -
+           O - - - - - - - - - - - - - - - - - -
+            - - - - - - - - - X - - - - - - - - -
+             - - - - - - - - - X - - - - - - - - -
+              - - - - - - - - - - - - - - - - - - -
+               - - - - - - - - - X - - - - - - - - -
+                - - - - - - - - - X - - - - - - - - -
+                 - - - - - - - - - - - - - - - - - - -
+                  - - - - - - - - - X - - - - - - - - -
+                   - - - - - - - - - X - - - - - - - - -
+                    - - - - - - - - - - - - - - - - - - -
+                     - - - - - - - - - X - - - - - - - - -
+                      - - - - - - - - - X - - - - - - - - -
+                       - - - - - - - - - - - - - - - - - - -
+                        - - - - - - - - - X - - - - - - - - -
+                         )")},
+    {'X', 'X', Board<19>(R"(
+      - - - - - - - - - X O - - - - - - - -
+       - - - - - - - - - X O - - - - - - - -
+        - - - - - - - - - X O - - - - - - - -
+         - - - - - - - - - X O - - - - - - - -
+          - - - - - - - - - X O - - - - - - - -
+           - - - - - - - - - X O - - - - - - - -
+            - - - - - - - - - X O - - - - - - - -
+             - - - - - - - - - X O - - - - - - - -
+              - - - - - - - - - X O - - - - - - - -
+               - - - - - - - - - X O - - - - - - - -
+                - - - - - - - - - X O - - - - - - - -
+                 - - - - - - - - - X O - - - - - - - -
+                  - - - - - - - - - X O - - - - - - - -
+                   - - - - - - - - - X O - - - - - - - -
+                    - - - - - - - - - X O - - - - - - - -
+                     - - - - - - - - - X O - - - - - - - -
+                      - - - - - - - - - X O - - - - - - - -
+                       - - - - - - - - - X O - - - - - - - -
+                        - - - - - - - - - X O - - - - - - - -
+                         )")},
+    {'?', '?', Board<19>(R"(
+      - - - - - - - - - - - - - - - - - - -
+       - - - - - - - - - - - - - - - - - - -
+        - - - - - - - - - - - - - - - - - - -
+         - - - - - - - - - - - - - - - - - - -
+          - - - - - - - - - - - - - - - - - - -
+           - - - - - - - - - - - - - - - - - - -
+            - - - - - - - - - - - - - - - - - - -
+             - - - - - - - - - - - - - - - - - - -
+              - - - - - - - - - - - - - - - - - - -
+               - - - - - - - - - - - - - - - - - - -
+                - - - - - - - - - - - - - - - - - - -
+                 - - - - - - - - - - - - - - - - - - -
+                  - - - - - - - - - - - - - - - - - - -
+                   - - - - - - - - - - - - - - - - - - -
+                    - - - - - - - - - - - - - - - - - - -
+                     - - - - - - - - - - - - - - - - - - -
+                      - - - - - - - - - - - - - - - - - - -
+                       - - - - - - - - - - - - - - - - - - -
+                        - - - - - - - - - - - - - - - - - - -
+                         )")},
+});
+
 template<bitpos N>
 void runWinnerTests(std::vector< winnerTest<N> > tests) {
   int index = -1;
@@ -372,4 +670,100 @@ TEST(BoardWinner, WinnerTestLists) {
   runWinnerTests(tests5);
   runWinnerTests(tests7);
   runWinnerTests(tests8);
+  runWinnerTests(tests14);
+  runWinnerTests(tests15);
+  runWinnerTests(tests16);
+  runWinnerTests(tests17);
+  runWinnerTests(tests18);
+  runWinnerTests(tests19);
+}
+
+// The symmetries map a win for a player to a win for the same player, or,
+// for the transposes, for the other player.
+template<bitpos N>
+void runSymmetryTests(std::vector< winnerTest<N> > tests) {
+  for (auto test : tests) {
+    for (Symmetry s : {ROTATE180, TRANSPOSE, ANTI_TRANSPOSE}) {
+      char w = test.board.transformed(s).winner();
+      if (swapsPlayers(s) && w != '?') {
+        w = 'X' + 'O' - w;
+      }
+      EXPECT_EQ(test.winner, w) << s << std::endl << test.board;
+    }
+  }
+}
+
+TEST(BoardWinner, Symmetries) {
+  runSymmetryTests(tests5);
+  runSymmetryTests(tests8);
+  runSymmetryTests(tests14);
+  runSymmetryTests(tests19);
+}
+
+// A sub-board's edges stand in for the real ones, so a chain that crosses a
+// window wins on the sub-board even when it does not reach the real edges.
+TEST(BoardWinner, SubBoard) {
+  const Board<9> b(R"(- - - - - - - - -
+                       - - - - - - - - -
+                        - - - X - - - - -
+                         - - - X O - - - -
+                          - - X - O - - - -
+                           - - X O - - - - -
+                            - - - - - - - - -
+                             - - - - - - - - -
+                              - - - - - - - - -)");
+  EXPECT_EQ('?', b.winner());
+  EXPECT_EQ('X', b.subBoard<4>(2, 2).winner());
+  EXPECT_EQ('?', b.subBoard<4>(2, 2).winner('O'));
+  EXPECT_EQ('O', b.subBoard<2>(4, 3).winner());
+  EXPECT_EQ('?', b.subBoard<4>(1, 2).winner('X'));
+}
+
+// A PaddedBoard agrees with the Board it was made from.
+template<bitpos N>
+void runPaddedTests(std::vector< winnerTest<N> > tests) {
+  for (auto test : tests) {
+    const PaddedBoard<N> padded(test.board);
+    EXPECT_EQ(test.winner, padded.winner()) << std::endl << test.board;
+    EXPECT_EQ(test.vcWinner, padded.virtualWinner()) << std::endl << test.board;
+    EXPECT_EQ(test.board, padded.board());
+  }
+}
+
+// Plays a random game on a Board<N> and a PaddedBoard<N> at once, checking
+// after every move that they agree.
+template<bitpos N>
+void testPaddedGame(unsigned seed) {
+  const std::vector<int> cells = randomGame<N>(seed);
+  Board<N> b;
+  PaddedBoard<N> padded;
+  for (int cell : cells) {
+    b.go(cell);
+    padded.go(cell);
+    ASSERT_EQ(b.winner(), padded.winner()) << std::endl << b;
+    ASSERT_EQ(b.winner('O'), padded.winner('O')) << std::endl << b;
+    ASSERT_EQ(b.virtualWinner(), padded.virtualWinner()) << std::endl << b;
+  }
+  EXPECT_EQ(b, padded.board());
+  EXPECT_THROW(padded.go(cells[0]), Panic);
+  EXPECT_THROW(padded.go(N*N), Panic);
+}
+
+TEST(BoardWinner, PaddedBoard) {
+  runPaddedTests(tests2);
+  runPaddedTests(tests3);
+  runPaddedTests(tests5);
+  runPaddedTests(tests7);
+  runPaddedTests(tests8);
+  runPaddedTests(tests14);
+  runPaddedTests(tests19);
+  for (unsigned seed = 1; seed <= 4; ++seed) {
+    testPaddedGame<1>(seed);
+    testPaddedGame<4>(seed);
+    testPaddedGame<7>(seed);
+    testPaddedGame<8>(seed);
+    testPaddedGame<10>(seed);
+    testPaddedGame<11>(seed);
+    testPaddedGame<13>(seed);
+  }
 }
@@ -1,5 +1,10 @@
+#include <string.h>
+#include <string>
 #include "panic.h"
 #include "bitops.h"
+#ifdef BITOPS_DISPATCH_BMI2
+#include <cpuid.h>
+#endif
 
 ////////////////////////////////////////////////////////////////////////
 // Utility functions
@@ -437,4 +442,185 @@ int lowestBitPositionLoop(uint64_t q) {
   return maxbit + 1;
 }
 
+// selectBitPositionLoop returns the position of the k'th lowest 1 in q by
+// clearing the lowest 1 k times. Panics unless 0 ≤ k < countBits(q).
+int selectBitPositionLoop(uint64_t q, int k) {
+	if (k < 0 || k >= countBits(q)) {
+		panic("selectBitPosition(%llx, %d): k out of range",
+			(unsigned long long)q, k);
+	}
+	for (; k > 0; --k) {
+		q &= q - 1;
+	}
+	return lowestBitPosition(q);
+}
+
+// selectBitPositionBroadword returns the position of the k'th lowest 1 in q.
+// It counts the bits in each byte in parallel, as countBitsCunning does, and
+// then uses a multiplication to turn those counts into running totals, which
+// locate the byte holding the answer. Only the bits of that byte need to be
+// searched one at a time. Panics unless 0 ≤ k < countBits(q).
+int selectBitPositionBroadword(uint64_t q, int k) {
+	uint64_t s = q - ((q >> 1) & (ones / 3));
+	s = (s & (ones / 5)) + ((s >> 2) & (ones / 5));
+	s = (s + (s >> 4)) & (ones / 17);
+	// Byte i of totals is the number of 1's in bytes 0 through i of q.
+	uint64_t totals = s * (ones / 255);
+	if (k < 0 || k >= int(totals >> 56)) {
+		panic("selectBitPosition(%llx, %d): k out of range",
+			(unsigned long long)q, k);
+	}
+	int byte = 0;
+	while (int((totals >> (8 * byte)) & 0xFF) <= k) {
+		++byte;
+	}
+	if (byte > 0) {
+		k -= int((totals >> (8 * (byte - 1))) & 0xFF);
+	}
+	uint64_t bits = (q >> (8 * byte)) & 0xFF;
+	for (; k > 0; --k) {
+		bits &= bits - 1;
+	}
+	return 8 * byte + lowestBitPosition(bits);
+}
+
+// extractBitsLoop is the portable version of PEXT; it takes one iteration per
+// 1 in mask.
+uint64_t extractBitsLoop(uint64_t q, uint64_t mask) {
+	uint64_t result = 0;
+	for (uint64_t bit = 1; mask != 0; bit <<= 1) {
+		uint64_t lowest = mask & -mask;
+		if ((q & lowest) != 0) {
+			result |= bit;
+		}
+		mask ^= lowest;
+	}
+	return result;
+}
+
+// depositBitsLoop is the portable version of PDEP; it takes one iteration per
+// 1 in mask.
+uint64_t depositBitsLoop(uint64_t q, uint64_t mask) {
+	uint64_t result = 0;
+	for (uint64_t bit = 1; mask != 0; bit <<= 1) {
+		uint64_t lowest = mask & -mask;
+		if ((q & bit) != 0) {
+			result |= lowest;
+		}
+		mask ^= lowest;
+	}
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Runtime dispatch
+//
+
+#ifdef BITOPS_DISPATCH
+__attribute__ ((target ("popcnt")))
+int countBitsPopcnt(uint64_t q) {
+	return __builtin_popcountll(q);
+}
+#endif
+
+#ifdef BITOPS_DISPATCH_BMI2
+// Returns whether the CPU has BMI2, and its PEXT and PDEP are not microcoded,
+// as they are on AMD and Hygon CPUs before Zen 3 (family 19h).
+static bool detectFastBmi2() {
+	__builtin_cpu_init();
+	if (!__builtin_cpu_supports("bmi2")) {
+		return false;
+	}
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+		return false;
+	}
+	char vendor[13];
+	memcpy(vendor, &ebx, 4);
+	memcpy(vendor + 4, &edx, 4);
+	memcpy(vendor + 8, &ecx, 4);
+	vendor[12] = '\0';
+	if (strcmp(vendor, "AuthenticAMD") != 0 &&
+	    strcmp(vendor, "HygonGenuine") != 0) {
+		return true;
+	}
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		return false;
+	}
+	unsigned int family = (eax >> 8) & 0xF;
+	if (family == 0xF) {
+		family += (eax >> 20) & 0xFF;
+	}
+	return family >= 0x19;
+}
+
+extern const bool bitopsFastBmi2 = detectFastBmi2();
+#endif
+
+static std::string describeBitopsVariants() {
+	std::string result;
+#ifdef BITOPS_DISPATCH
+	__builtin_cpu_init();
+	result += __builtin_cpu_supports("popcnt") ?
+		"countBits: POPCNT instruction in BITOPS_CLONES loops (selected at "
+		"startup), countBitsInline elsewhere\n" :
+		"countBits: countBitsInline (the CPU has no POPCNT)\n";
+#elif defined(__POPCNT__)
+	result += "countBits: POPCNT instruction (selected at compile time)\n";
+#elif defined(__GNUC__)
+	result += "countBits: __builtin_popcountll\n";
+#else
+	result += "countBits: countBitsCunning\n";
+#endif
+
+#if defined(__GNUC__) && defined(__BMI__)
+	result += "lowestBitPosition: TZCNT instruction\n";
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	result += "lowestBitPosition: BSF instruction\n";
+#elif defined(__GNUC__)
+	result += "lowestBitPosition: __builtin_ctzll\n";
+#else
+	result += "lowestBitPosition: lowestBitPositionDeBruijn\n";
+#endif
+
+#if defined(__GNUC__) && defined(__LZCNT__)
+	result += "highestBitPosition: LZCNT instruction\n";
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	result += "highestBitPosition: BSR instruction\n";
+#elif defined(__GNUC__)
+	result += "highestBitPosition: __builtin_clzll\n";
+#else
+	result += "highestBitPosition: highestBitPositionDeBruijn\n";
+#endif
+
+#if defined(__GNUC__) && defined(__BMI2__)
+	result += "extractBits, depositBits, selectBitPosition: PEXT/PDEP "
+		"(selected at compile time)\n";
+#elif defined(BITOPS_DISPATCH_BMI2)
+	result += "extractBits, depositBits, selectBitPosition: portable";
+	result += bitopsFastBmi2 ?
+		"; PEXT/PDEP in BITOPS_BMI2 versions (selected at startup)\n" :
+		"; BITOPS_BMI2 versions not used on this CPU\n";
+#else
+	result += "extractBits, depositBits, selectBitPosition: portable\n";
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	result += "cpu:";
+	if (__builtin_cpu_supports("popcnt")) result += " popcnt";
+	if (__builtin_cpu_supports("bmi")) result += " bmi";
+	if (__builtin_cpu_supports("bmi2")) result += " bmi2";
+	if (__builtin_cpu_supports("avx2")) result += " avx2";
+	if (__builtin_cpu_supports("avx512f")) result += " avx512f";
+	result += "\n";
+#endif
+	return result;
+}
+
+const char *bitopsVariants() {
+	static std::string description = describeBitopsVariants();
+	return description.c_str();
+}
+
 ///////////////////////////////////////////////////////////////////////////////|
@@ -73,7 +73,41 @@ int countBitsByteTable(uint64_t q);
 // countBits implementation above.
 int countBitsWordTable(uint64_t q);
 
-#ifdef __GNUC__
+// countBitsInline is countBitsCunning's branch-free count, inline. GCC
+// recognizes it as a population count, and compiles it to the POPCNT
+// instruction where it may assume the CPU has one.
+inline constexpr int countBitsInline(uint64_t q) {
+  q -= (q >> 1) & 0x5555555555555555ULL;
+  q = (q & 0x3333333333333333ULL) + ((q >> 2) & 0x3333333333333333ULL);
+  q = (q + (q >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return int((q * 0x0101010101010101ULL) >> 56);
+}
+
+// On x86, __builtin_popcountll compiles to the POPCNT instruction only where
+// the compiler may assume the CPU has it: with -mpopcnt or -march=native, or
+// in a function compiled for such a target. Elsewhere it is a call to
+// libgcc, which benchmarking shows is slower than countBitsInline. So, in a
+// build that does not assume POPCNT (BITOPS_DISPATCH), countBits is
+// countBitsInline, and the loops that count many words are marked
+// BITOPS_CLONES, which compiles each of them twice, with and without POPCNT,
+// and has the program pick one version when it starts, according to the CPU
+// it is running on (GCC's function multiversioning, through an ifunc). The
+// counts in the POPCNT version are POPCNT instructions. Mark the outermost
+// hot loop, not the functions it calls: a cloned function is never inlined.
+#if defined(__GNUC__) && !defined(__POPCNT__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define BITOPS_DISPATCH 1
+#define BITOPS_CLONES __attribute__((target_clones("popcnt", "default")))
+
+// countBitsPopcnt uses the POPCNT instruction. Call it only if the CPU has one.
+int countBitsPopcnt(uint64_t q);
+#else
+#define BITOPS_CLONES
+#endif
+
+#ifdef BITOPS_DISPATCH
+#define countBits(q) countBitsInline(q)
+#elif defined(__GNUC__)
 #define countBits(q) __builtin_popcountll(q)
 #else
 #define countBits(q) countBitsCunning(q)
@@ -88,5 +122,94 @@ int countBitsWordTable(uint64_t q);
 //   #endif
 // }
 
+
+// selectBitPosition returns the position of the k'th lowest 1 in q, counting
+// from k = 0 (so selectBitPosition(q, 0) == lowestBitPosition(q)).
+// Requires 0 ≤ k < countBits(q).
+int selectBitPositionLoop(uint64_t q, int k);
+int selectBitPositionBroadword(uint64_t q, int k);
+
+// extractBits gathers the bits of q at the positions of the 1's in mask into
+// the low-order bits of the result, keeping their order (x86 BMI2 PEXT).
+uint64_t extractBitsLoop(uint64_t q, uint64_t mask);
+
+// depositBits scatters the low-order bits of q to the positions of the 1's in
+// mask, keeping their order (x86 BMI2 PDEP). It is the inverse of extractBits:
+// extractBits(depositBits(q, mask), mask) == q & bit_mask(0, countBits(mask)-1).
+uint64_t depositBitsLoop(uint64_t q, uint64_t mask);
+
+// With BMI2 (e.g., -mbmi2 or -march=native), these use PEXT and PDEP.
+// Beware that on AMD CPUs before Zen 3, PEXT and PDEP are microcoded and much
+// slower than the portable versions.
+#if defined(__GNUC__) && defined(__BMI2__)
+#include <immintrin.h>
+#define extractBits(q, mask) _pext_u64(q, mask)
+#define depositBits(q, mask) _pdep_u64(q, mask)
+#define selectBitPosition(q, k) __builtin_ctzll(_pdep_u64(1ULL << (k), q))
+#else
+#define extractBits(q, mask) extractBitsLoop(q, mask)
+#define depositBits(q, mask) depositBitsLoop(q, mask)
+#define selectBitPosition(q, k) selectBitPositionBroadword(q, k)
+#endif
+
+// In an x86-64 build that does not assume BMI2 (BITOPS_DISPATCH_BMI2), the
+// quadset operations built on PEXT and PDEP (select, compress, and expand; see
+// qset_words.h) have a second version, compiled with BITOPS_BMI2, which they
+// call when bitopsFastBmi2 is set. bitopsFastBmi2 is set at startup if the CPU
+// has BMI2, unless it is an AMD (or Hygon) CPU before Zen 3, whose PEXT and
+// PDEP are microcoded. It is false until then, so that code run by static
+// initializers uses the portable versions.
+#if defined(__GNUC__) && !defined(__BMI2__) && defined(__x86_64__)
+#define BITOPS_DISPATCH_BMI2 1
+#define BITOPS_BMI2 __attribute__((target("bmi2,popcnt")))
+#include <immintrin.h>
+extern const bool bitopsFastBmi2;
+#endif
+
+// nextCombination returns the next larger number with the same count of 1's
+// as q (Gosper's hack), or 0 if there is none. Starting from
+// bitRange(0, k-1), it visits every k-element subset of 0..63 in increasing
+// order. Requires q ≠ 0.
+inline uint64_t nextCombination(uint64_t q) {
+  const uint64_t ripple = q + (q & -q);
+  if (ripple == 0) {
+    return 0; // The 1's of q were already the highest-order bits.
+  }
+  // Two shifts, since 2 + lowestBitPosition(q) is 64 when q = 1 << 62.
+  return ripple | (((q ^ ripple) >> 2) >> lowestBitPosition(q));
+}
+
+// nextSubmask returns the next smaller subset of mask after s, that is,
+// (s - 1) & mask. Starting from s = mask, it visits every subset of mask in
+// decreasing order, ending with 0. Requires s ≠ 0.
+inline uint64_t nextSubmask(uint64_t s, uint64_t mask) {
+  return (s - 1) & mask;
+}
+
+// reverseBits returns q with its bits in the opposite order: bit i of the
+// result is bit 63-i of q. It swaps adjacent bits, pairs, and nibbles, and then
+// reverses the bytes.
+inline constexpr uint64_t reverseBits(uint64_t q) {
+  q = ((q >> 1) & 0x5555555555555555ULL) | ((q & 0x5555555555555555ULL) << 1);
+  q = ((q >> 2) & 0x3333333333333333ULL) | ((q & 0x3333333333333333ULL) << 2);
+  q = ((q >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((q & 0x0F0F0F0F0F0F0F0FULL) << 4);
+#ifdef __GNUC__
+  return __builtin_bswap64(q);
+#else
+  q = ((q >> 8) & 0x00FF00FF00FF00FFULL) | ((q & 0x00FF00FF00FF00FFULL) << 8);
+  q = ((q >> 16) & 0x0000FFFF0000FFFFULL) | ((q & 0x0000FFFF0000FFFFULL) << 16);
+  return (q >> 32) | (q << 32);
+#endif
+}
+
+// bitopsVariants returns a description of the implementations chosen for
+// countBits, lowestBitPosition, highestBitPosition, extractBits, depositBits,
+// and selectBitPosition, including the versions picked at startup, and of the
+// relevant features of the CPU.
+// lowestBitPosition and highestBitPosition never need runtime dispatch: on x86
+// their builtins compile to BSF/BSR, or to TZCNT/LZCNT if the compiler may
+// assume BMI/LZCNT, and never to library calls.
+const char *bitopsVariants();
+
 ///////////////////////////////////////////////////////////////////////////////|
 #endif /* __BITOPS_H__ */
@@ -8,8 +8,14 @@
 
 quadset<64> random_quads[1000];
 unsigned long long random_u64s[1000];
+unsigned long long random_masks[1000];
+quadset<169> random_sets[1000];
+quadset<128> random_sets128[1000];
+bitpos random_shifts[1 << 16];
 
 void build_random_quads() {
+  std::minstd_rand generator;
+  std::uniform_int_distribution<int> shift_dist(0, 168);
   //std::minstd_rand generator;
   //std::uniform_int_distribution<unsigned long long> ull_dist;
   //auto rand = std::bind(ull_dist, generator);
@@ -22,6 +28,14 @@ void build_random_quads() {
     //random_u64s[i] = r;
     random_quads[i] = quadset<64>(i+1);
     random_u64s[i] = i+1;
+    random_masks[i] = (i+1) * 0x9E3779B97F4A7C15ULL;
+    random_sets[i] = quadset<169>::make({
+        bitpos(i % 169), bitpos((i * 7) % 169), bitpos((i * 31) % 169), 168});
+    random_sets128[i] = quadset<128>::make({
+        bitpos(i % 128), bitpos((i * 7) % 128), bitpos((i * 31) % 128), 127});
+  }
+  for (int i = 0; i < sizeof(random_shifts)/sizeof(random_shifts[0]); i++) {
+    random_shifts[i] = shift_dist(generator);
   }
 }
 
@@ -197,6 +211,16 @@ void Benchmark_CountBitsCunning(Benchmark &b) {
   globalSum += localSum;
 }
 
+void Benchmark_CountBitsInline(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += countBitsInline(random_u64s[j]);
+    }
+  }
+  globalSum += localSum;
+}
+
 void Benchmark_CountBitsByteTable(Benchmark &b) {
   unsigned long long localSum = 0;
   for (int i = 0; i < b.N; ++i) {
@@ -227,6 +251,18 @@ void Benchmark_Popcount(Benchmark &b) {
   globalSum += localSum;
 }
 
+#ifdef BITOPS_DISPATCH
+void Benchmark_CountBitsPopcnt(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += countBitsPopcnt(random_u64s[j]);
+    }
+  }
+  globalSum += localSum;
+}
+#endif
+
 void Benchmark_CountBits(Benchmark &b) {
   unsigned long long localSum = 0;
   for (int i = 0; i < b.N; ++i) {
@@ -237,7 +273,212 @@ void Benchmark_CountBits(Benchmark &b) {
   globalSum += localSum;
 }
 
-int main() {
+// Benchmark_CountBitsClones is Benchmark_CountBits with its loop compiled by
+// BITOPS_CLONES, as the hot counting loops are.
+BITOPS_CLONES
+void Benchmark_CountBitsClones(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += countBits(random_u64s[j]);
+    }
+  }
+  globalSum += localSum;
+}
+
+// Selects the middle set bit of each sample.
+void Benchmark_SelectBitPositionLoop(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += selectBitPositionLoop(random_u64s[j], countBits(random_u64s[j]) >> 1);
+    }
+  }
+  globalSum += localSum;
+}
+
+void Benchmark_SelectBitPositionBroadword(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += selectBitPositionBroadword(random_u64s[j], countBits(random_u64s[j]) >> 1);
+    }
+  }
+  globalSum += localSum;
+}
+
+void Benchmark_SelectBitPosition(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += selectBitPosition(random_u64s[j], countBits(random_u64s[j]) >> 1);
+    }
+  }
+  globalSum += localSum;
+}
+
+void Benchmark_ExtractBitsLoop(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += extractBitsLoop(random_u64s[j], random_masks[j]);
+    }
+  }
+  globalSum += localSum;
+}
+
+void Benchmark_ExtractBits(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += extractBits(random_u64s[j], random_masks[j]);
+    }
+  }
+  globalSum += localSum;
+}
+
+void Benchmark_DepositBitsLoop(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += depositBitsLoop(random_u64s[j], random_masks[j]);
+    }
+  }
+  globalSum += localSum;
+}
+
+void Benchmark_DepositBits(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_u64s)/sizeof(random_u64s[0]); ++j) {
+      localSum += depositBits(random_u64s[j], random_masks[j]);
+    }
+  }
+  globalSum += localSum;
+}
+
+// Finds the middle element of a 169-bit set, first by testing each position in
+// turn and then with select().
+void Benchmark_QuadsetSelectByTest(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_sets)/sizeof(random_sets[0]); ++j) {
+      const quadset<169> &s = random_sets[j];
+      bitpos k = s.count() >> 1;
+      for (bitpos pos = 0; pos < 169; ++pos) {
+        if (s.test(pos) && k-- == 0) {
+          localSum += pos;
+          break;
+        }
+      }
+    }
+  }
+  globalSum += localSum;
+}
+
+void Benchmark_QuadsetSelect(Benchmark &b) {
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_sets)/sizeof(random_sets[0]); ++j) {
+      localSum += random_sets[j].select(random_sets[j].count() >> 1);
+    }
+  }
+  globalSum += localSum;
+}
+
+// Shifts by random distances (0 through 168, so some are larger than the
+// 128-bit sets), comparing the branch-ladder shift operators with the
+// branchless shifts. There are 64K distances, too many for the branch
+// predictor to learn the sequence.
+void Benchmark_ShiftLeft128(Benchmark &b) {
+  quadset<128> acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_shifts)/sizeof(random_shifts[0]); ++j) {
+      acc ^= random_sets128[j & 511] << random_shifts[j];
+    }
+  }
+  globalSum += acc.count();
+}
+
+void Benchmark_BranchlessShiftLeft128(Benchmark &b) {
+  quadset<128> acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_shifts)/sizeof(random_shifts[0]); ++j) {
+      acc ^= random_sets128[j & 511].branchless_lsh(random_shifts[j]);
+    }
+  }
+  globalSum += acc.count();
+}
+
+void Benchmark_ShiftRight128(Benchmark &b) {
+  quadset<128> acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_shifts)/sizeof(random_shifts[0]); ++j) {
+      acc ^= random_sets128[j & 511] >> random_shifts[j];
+    }
+  }
+  globalSum += acc.count();
+}
+
+void Benchmark_BranchlessShiftRight128(Benchmark &b) {
+  quadset<128> acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_shifts)/sizeof(random_shifts[0]); ++j) {
+      acc ^= random_sets128[j & 511].branchless_rsh(random_shifts[j]);
+    }
+  }
+  globalSum += acc.count();
+}
+
+void Benchmark_ShiftLeft169(Benchmark &b) {
+  quadset<169> acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_shifts)/sizeof(random_shifts[0]); ++j) {
+      acc ^= random_sets[j & 511] << random_shifts[j];
+    }
+  }
+  globalSum += acc.count();
+}
+
+void Benchmark_BranchlessShiftLeft169(Benchmark &b) {
+  quadset<169> acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_shifts)/sizeof(random_shifts[0]); ++j) {
+      acc ^= random_sets[j & 511].branchless_lsh(random_shifts[j]);
+    }
+  }
+  globalSum += acc.count();
+}
+
+void Benchmark_ShiftRight169(Benchmark &b) {
+  quadset<169> acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_shifts)/sizeof(random_shifts[0]); ++j) {
+      acc ^= random_sets[j & 511] >> random_shifts[j];
+    }
+  }
+  globalSum += acc.count();
+}
+
+void Benchmark_BranchlessShiftRight169(Benchmark &b) {
+  quadset<169> acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < sizeof(random_shifts)/sizeof(random_shifts[0]); ++j) {
+      acc ^= random_sets[j & 511].branchless_rsh(random_shifts[j]);
+    }
+  }
+  globalSum += acc.count();
+}
+
+// With the argument --variants, bitops_benchmark just reports which bitops
+// implementations were selected for this build and CPU. Otherwise it reports
+// them and then runs the benchmarks.
+int main(int argc, char **argv) {
+  std::cout << bitopsVariants();
+  if (argc > 1 && strcmp(argv[1], "--variants") == 0) {
+    return 0;
+  }
+  std::cout << std::endl;
   build_random_quads();
 
   BENCHMARK(Benchmark_LowestBitPositionFloodFill);
@@ -261,9 +502,37 @@ int main() {
 
   BENCHMARK(Benchmark_CountBitsLoop);
   BENCHMARK(Benchmark_CountBitsCunning);
+  BENCHMARK(Benchmark_CountBitsInline);
   BENCHMARK(Benchmark_CountBitsByteTable);
   BENCHMARK(Benchmark_CountBitsWordTable);
   BENCHMARK(Benchmark_Popcount);
+#ifdef BITOPS_DISPATCH
+  if (__builtin_cpu_supports("popcnt")) {
+    BENCHMARK(Benchmark_CountBitsPopcnt);
+  }
+#endif
   BENCHMARK(Benchmark_CountBits);
+  BENCHMARK(Benchmark_CountBitsClones);
+  std::cout << std::endl;
+
+  BENCHMARK(Benchmark_SelectBitPositionLoop);
+  BENCHMARK(Benchmark_SelectBitPositionBroadword);
+  BENCHMARK(Benchmark_SelectBitPosition);
+  BENCHMARK(Benchmark_ExtractBitsLoop);
+  BENCHMARK(Benchmark_ExtractBits);
+  BENCHMARK(Benchmark_DepositBitsLoop);
+  BENCHMARK(Benchmark_DepositBits);
+  BENCHMARK(Benchmark_QuadsetSelectByTest);
+  BENCHMARK(Benchmark_QuadsetSelect);
+  std::cout << std::endl;
+
+  BENCHMARK(Benchmark_ShiftLeft128);
+  BENCHMARK(Benchmark_BranchlessShiftLeft128);
+  BENCHMARK(Benchmark_ShiftRight128);
+  BENCHMARK(Benchmark_BranchlessShiftRight128);
+  BENCHMARK(Benchmark_ShiftLeft169);
+  BENCHMARK(Benchmark_BranchlessShiftLeft169);
+  BENCHMARK(Benchmark_ShiftRight169);
+  BENCHMARK(Benchmark_BranchlessShiftRight169);
   return 0;
 }
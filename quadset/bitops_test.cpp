@@ -1,4 +1,5 @@
 /* vim: set ft=cpp tw=75: */
+#include <vector>
 #include <string.h>
 #include "bitops.h"
 #include "quadset.h"
@@ -15,8 +16,66 @@ TEST(SET, CountBits) {
     EXPECT_EQ(loopCount, countBitsByteTable(u64));
     EXPECT_EQ(loopCount, countBitsWordTable(u64));
     EXPECT_EQ(loopCount, countBitsCunning(u64));
+    EXPECT_EQ(loopCount, countBitsInline(u64));
     EXPECT_EQ(loopCount, __builtin_popcountll(u64));
+#ifdef BITOPS_DISPATCH
+    if (__builtin_cpu_supports("popcnt")) {
+      EXPECT_EQ(loopCount, countBitsPopcnt(u64));
+    }
+#endif
+  }
+}
+
+// countBits, and the counts built on it, are constant expressions when their
+// arguments are.
+TEST(SET, ConstexprCountBits) {
+  static_assert(countBits(uint64_t(0xF0F0)) == 8, "countBits");
+  static_assert(quadset<10>(0x3FF).count() == 10, "qset1 count()");
+  static_assert(quadset<100>(0xFF).count() == 8, "qset2 count()");
+  constexpr quadset<200> set = quadset<200>(0x7);
+  static_assert(set.count() == 3, "qset4 count()");
+  EXPECT_EQ(8, countBits(uint64_t(0xF0F0)));
+}
+
+// countCloned is a loop compiled twice by BITOPS_CLONES, with and without
+// POPCNT (when the build does not assume it).
+BITOPS_CLONES
+int countCloned(const uint64_t *words, int n) {
+  int result = 0;
+  for (int i = 0; i < n; ++i) {
+    result += countBits(words[i]);
+  }
+  return result;
+}
+
+TEST(SET, CountBitsClones) {
+  auto samples = getTestSets<64>();
+  std::vector<uint64_t> words;
+  int expected = 0;
+  for (int i = 0; i < samples->quadsets.size(); ++i) {
+    words.push_back(samples->quadsets.at(i).b0);
+    expected += countBitsLoop(words.back());
   }
+  EXPECT_EQ(expected, countCloned(words.data(), words.size()));
+}
+
+TEST(SET, BitopsVariants) {
+  std::string variants = bitopsVariants();
+  EXPECT_NE(std::string::npos, variants.find("countBits: "));
+  EXPECT_NE(std::string::npos, variants.find("lowestBitPosition: "));
+  EXPECT_NE(std::string::npos, variants.find("highestBitPosition: "));
+#ifdef BITOPS_DISPATCH
+  EXPECT_EQ(__builtin_cpu_supports("popcnt") != 0,
+            variants.find("POPCNT instruction in BITOPS_CLONES") !=
+            std::string::npos);
+#endif
+#ifdef BITOPS_DISPATCH_BMI2
+  if (bitopsFastBmi2) {
+    EXPECT_TRUE(__builtin_cpu_supports("bmi2"));
+  }
+  EXPECT_EQ(bitopsFastBmi2,
+            variants.find("PEXT/PDEP in BITOPS_BMI2") != std::string::npos);
+#endif
 }
 
 TEST(SET, LowestSetBit) {
@@ -53,3 +112,94 @@ TEST(SET, HighestSetBit) {
     }
   }
 }
+
+TEST(SET, SelectBitPosition) {
+  auto samples = getTestSets<64>();
+  for (int i = 0; i < samples->quadsets.size(); ++i) {
+    uint64_t u64 = samples->quadsets.at(i).b0;
+    int k = 0;
+    for (int pos = 0; pos < 64; ++pos) {
+      if ((u64 >> pos) & 1) {
+        EXPECT_EQ(pos, selectBitPositionLoop(u64, k));
+        EXPECT_EQ(pos, selectBitPositionBroadword(u64, k));
+        EXPECT_EQ(pos, selectBitPosition(u64, k));
+        ++k;
+      }
+    }
+  }
+}
+
+TEST(SET, ExtractDepositBits) {
+  auto samples = getTestSets<64>();
+  for (int i = 0; i < samples->quadsets.size(); ++i) {
+    uint64_t u64 = samples->quadsets.at(i).b0;
+    for (int j = 0; j < samples->quadsets.size(); j += 7) {
+      uint64_t mask = samples->quadsets.at(j).b0;
+      uint64_t want = 0;
+      int k = 0;
+      for (int pos = 0; pos < 64; ++pos) {
+        if ((mask >> pos) & 1) {
+          want |= ((u64 >> pos) & 1) << k;
+          ++k;
+        }
+      }
+      EXPECT_EQ(want, extractBitsLoop(u64, mask));
+      EXPECT_EQ(want, extractBits(u64, mask));
+      EXPECT_EQ(u64 & mask, depositBitsLoop(want, mask));
+      EXPECT_EQ(u64 & mask, depositBits(want, mask));
+    }
+  }
+}
+
+TEST(SET, NextCombination) {
+  // Every 3-element subset of 0..9, in increasing order.
+  int visited = 0;
+  uint64_t previous = 0;
+  for (uint64_t q = 0x7; q < (1ULL << 10); q = nextCombination(q)) {
+    EXPECT_LT(previous, q);
+    EXPECT_EQ(3, countBits(q));
+    previous = q;
+    ++visited;
+  }
+  EXPECT_EQ(120, visited);
+
+  EXPECT_EQ(0x0BULL, nextCombination(0x07ULL));
+  EXPECT_EQ(0x13ULL, nextCombination(0x0EULL));
+  EXPECT_EQ(0ULL, nextCombination(0xC000000000000000ULL));
+  EXPECT_EQ(0x8000000000000001ULL, nextCombination(0x6000000000000000ULL));
+
+  // Every 1-element subset of 0..63, up to the highest bit.
+  visited = 0;
+  for (uint64_t q = 1; q != 0; q = nextCombination(q)) {
+    EXPECT_EQ(1ULL << visited, q);
+    ++visited;
+  }
+  EXPECT_EQ(64, visited);
+  EXPECT_EQ(1ULL << 63, nextCombination(1ULL << 62));
+  EXPECT_EQ(0ULL, nextCombination(1ULL << 63));
+}
+
+TEST(SET, NextSubmask) {
+  const uint64_t mask = 0x8000000100F00013ULL;
+  std::vector<uint64_t> visited;
+  for (uint64_t s = mask; s != 0; s = nextSubmask(s, mask)) {
+    EXPECT_EQ(0ULL, s & ~mask);
+    if (!visited.empty()) {
+      EXPECT_LT(s, visited.back());
+    }
+    visited.push_back(s);
+  }
+  EXPECT_EQ(size_t(1) << countBits(mask), visited.size() + 1);
+}
+
+TEST(SET, ReverseBits) {
+  EXPECT_EQ(0ULL, reverseBits(0));
+  EXPECT_EQ(0x8000000000000000ULL, reverseBits(1));
+  EXPECT_EQ(0x00000000000000F1ULL, reverseBits(0x8F00000000000000ULL));
+  EXPECT_EQ(0xC480000000000000ULL, reverseBits(0x123ULL));
+  uint64_t q = 0x0123456789ABCDEFULL;
+  for (int i = 0; i < 64; ++i) {
+    EXPECT_EQ((q >> i) & 1, (reverseBits(q) >> (63 - i)) & 1) << i;
+  }
+  EXPECT_EQ(q, reverseBits(reverseBits(q)));
+}
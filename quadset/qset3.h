@@ -4,6 +4,8 @@
 #include <stdexcept>
 #include "quadset.h"
 #include "bitops.h"
+#include "qset_words.h"
+#include "qset_avx2.h"
 
 // This is qset<BITS,3>, a bitset template class specialized for holding three
 // quadwords' worth of bits -- i.e., between 129 and 192 bits.
@@ -125,6 +127,49 @@ public:
     return !this->operator==(other);
   }
 
+  // Orders sets by their value as binary numbers (see qset_words.h).
+  inline constexpr bool operator<(qSet other) const {
+    return qset_less<qSet, 3>(*this, other);
+  }
+
+  // Returns a 64-bit hash of the set. Equal sets have equal hashes.
+  inline constexpr uint64_t hash() const {
+    return qset_hash<qSet, 3>(*this);
+  }
+
+  // Fused operations, each one pass over the quadwords (see qset_words.h).
+
+  // Returns whether this set and other have an element in common.
+  inline constexpr bool intersects(qSet other) const {
+    return qset_intersects<qSet, 3>(*this, other);
+  }
+
+  // Returns whether every element of this set is in other.
+  inline constexpr bool is_subset_of(qSet other) const {
+    return !qset_any_andnot<qSet, 3>(*this, other);
+  }
+
+  // Returns whether this set has an element that is not in other.
+  inline constexpr bool any_andnot(qSet other) const {
+    return qset_any_andnot<qSet, 3>(*this, other);
+  }
+
+  // Returns the number of elements in both this set and other.
+  inline bitpos count_and(qSet other) const {
+    return qset_count_and<qSet, 3>(*this, other);
+  }
+
+  // Returns whether count() >= k, without necessarily counting every word.
+  inline bool count_at_least(bitpos k) const {
+    return qset_count_at_least<qSet, 3>(*this, k);
+  }
+
+  // Adds the elements of other to this set, and returns whether that changed
+  // the set.
+  inline bool union_changed(qSet other) {
+    return qset_union_changed<qSet, 3>(this, other);
+  }
+
   // Returns whether the bit at position pos is set (i.e., whether it is 1).
   inline constexpr bool test(bitpos pos) const {
     switch (pos >> 6) {
@@ -136,6 +181,52 @@ public:
     }
   }
 
+  // Returns quadword i of the set (elements 64*i through 64*i+63, with
+  // element 64*i in the low-order bit), or 0 if i is out of range.
+  inline constexpr uint64_t word(bitpos i) const {
+    switch (i) {
+      case  0: return b0;
+      case  1: return b1;
+      case  2: return b2;
+      default: return 0;
+    }
+  }
+
+  // Replaces quadword i of the set with value. The caller is responsible for
+  // keeping the unused bits of the last quadword clear.
+  inline qSet& set_word(bitpos i, uint64_t value) {
+    switch (i) {
+      case  0: b0 = value; break;
+      case  1: b1 = value; break;
+      case  2: b2 = value; break;
+      default: throw std::out_of_range("qset.set_word(i)");
+    }
+    return *this;
+  }
+
+  // Returns the k'th smallest element of the set, counting from k = 0.
+  // Panics unless 0 ≤ k < count().
+  inline bitpos select(bitpos k) const {
+    return qset_select<qSet, 3>(*this, k);
+  }
+
+  // Returns the number of elements of the set that are less than pos.
+  inline bitpos rank(bitpos pos) const {
+    return qset_rank<qSet, 3>(*this, pos);
+  }
+
+  // Returns the elements of the set that are also in mask, each renumbered by
+  // its rank in mask (see qset_words.h).
+  inline qSet compress(qSet mask) const {
+    return qset_compress<qSet, 3>(*this, mask);
+  }
+
+  // Returns the inverse of compress(mask): element k of the set becomes the
+  // k'th element of mask.
+  inline qSet expand(qSet mask) const {
+    return qset_expand<qSet, 3>(*this, mask);
+  }
+
   // Returns the quadword representation of the low-order 64 elements of the
   // set. Throws std::overflow_error if any high-order elements are present.
   inline constexpr uint64_t to_ullong() const {
@@ -215,6 +306,58 @@ public:
     }
   }
 
+  // shl<n>(), fast_shl<n>(), and shr<n>() are operator<<(n), fast_lsh(n), and
+  // operator>>(n) for a shift distance known at compile time. Each result
+  // word is computed directly, with none of the range tests of the runtime
+  // versions.
+  template<bitpos n>
+  inline constexpr qSet shl() const {
+    return fast_shl<n>().clean();
+  }
+
+  template<bitpos n>
+  inline constexpr qSet fast_shl() const {
+    static_assert(n >= 0, "qset.fast_shl<n>(): negative shift");
+    return qSet{qset_shl_word<n>(*this, 0),
+                qset_shl_word<n>(*this, 1),
+                qset_shl_word<n>(*this, 2)};
+  }
+
+  template<bitpos n>
+  inline constexpr qSet shr() const {
+    static_assert(n >= 0, "qset.shr<n>(): negative shift");
+    return qSet{qset_shr_word<n>(*this, 0),
+                qset_shr_word<n>(*this, 1),
+                qset_shr_word<n>(*this, 2)};
+  }
+  // Returns the set with its elements in the opposite order: element i
+  // becomes element BITS-1-i.
+  inline constexpr qSet reverse() const {
+    return qSet{reverseBits(b2), reverseBits(b1),
+                reverseBits(b0)}.template shr<192 - BITS>();
+  }
+
+  // branchless_lsh(n), fast_branchless_lsh(n), and branchless_rsh(n) are
+  // operator<<(n), fast_lsh(n), and operator>>(n) without the branches on n
+  // (see qset_words.h). They are faster when n varies unpredictably.
+  inline qSet branchless_lsh(bitpos n) const {
+    return fast_branchless_lsh(n).clean();
+  }
+
+  inline qSet fast_branchless_lsh(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.fast_branchless_lsh(): negative shift");
+    }
+    return qset_branchless_lsh<qSet, 3>(*this, n);
+  }
+
+  inline qSet branchless_rsh(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.branchless_rsh(): negative shift");
+    }
+    return qset_branchless_rsh<qSet, 3>(*this, n);
+  }
+
   inline constexpr qSet operator& (qSet other) const {
     return qSet{b0 & other.b0, b1 & other.b1, b2 & other.b2};
   }
@@ -572,6 +715,18 @@ public:
     return ::to_string(*this);
   }
 
+#ifdef QUADSET_AVX2
+  // Return the set in AVX2 register form (see qset_avx2.h).
+  inline quadvec to_quadvec() const {
+    return avx2_load(b0, b1, b2, 0);
+  }
+
+  // Return the set held in AVX2 register form by v.
+  static inline qSet from_quadvec(quadvec v) {
+    return qSet{avx2_lane<0>(v), avx2_lane<1>(v), avx2_lane<2>(v)};
+  }
+#endif
+
 };
 
 static_assert (std::is_pod< qset<192,3> >::value, "qset<BITS,3> must be POD");
@@ -0,0 +1,596 @@
+#ifndef __QSET4_H__
+#define __QSET4_H__
+#include <stdint.h>
+#include <stdexcept>
+#include "quadset.h"
+#include "bitops.h"
+#include "qset_words.h"
+#include "qset_avx2.h"
+
+// This is qset<BITS,4>, a bitset template class specialized for holding four
+// quadwords' worth of bits -- i.e., between 193 and 256 bits.
+
+template<bitpos BITS>
+class qset<BITS,4> {
+public:
+  uint64_t b0;
+  uint64_t b1;
+  uint64_t b2;
+  uint64_t b3;
+
+  static_assert (193 <= BITS && BITS <= 256,
+      "qset<BITS,4>: BITS must be in 193..256");
+
+  typedef qset<BITS,4> qSet;
+
+  static inline constexpr qSet from_ullong(uint64_t val) {
+    return qSet{val};
+  }
+
+  static inline constexpr qSet make() {
+    return qSet{0};
+  }
+
+  static inline constexpr qSet make(std::initializer_list<bitpos> list) {
+    qSet result;
+    result.reset();
+    for (int i : list) {
+      result.set(i);
+    }
+    return result;
+  }
+
+  static inline constexpr qSet range(bitpos m, bitpos n) {
+    qSet result = {0};
+    result.set(m, n);
+    return result;
+  }
+
+  static inline constexpr qSet universe() {
+    return qSet{uint64_t(~0ULL), uint64_t(~0ULL), uint64_t(~0ULL),
+                bit_mask(0, BITS-193)};
+  }
+
+  // Clear any set bits in the unused part of the storage.  This method exists
+  // for use as needed after fast_lsh(), fast_lsh_assign(), and/or fast_not().
+  inline constexpr qSet clean() {
+    return qSet{ b0, b1, b2, b3 & bit_mask(0, BITS-193) };
+  }
+
+  inline constexpr bitpos size() { return BITS; }
+
+  // Return true iff the set is nonempty.
+  inline constexpr bool any() const {
+    return (b0 | b1 | b2 | b3) != 0;
+  }
+
+  // Return true iff the set is empty.
+  inline constexpr bool none() const {
+    return !any();
+  }
+
+  // Return true iff all the bits in the set are 1.
+  inline constexpr bool all() const {
+    return this->operator==(universe());
+  }
+
+  // Return the minimum element of the set.
+  inline constexpr bitpos min() const {
+    if (b0 != 0) {
+      return lowestBitPosition(b0);
+    } else if (b1 != 0) {
+      return lowestBitPosition(b1) + 64;
+    } else if (b2 != 0) {
+      return lowestBitPosition(b2) + 128;
+    } else if (b3 != 0) {
+      return lowestBitPosition(b3) + 192;
+    } else {
+      panic("qset4.min(): cannot find any element in the empty set");
+      return 256;
+    }
+  }
+
+  // Return the maximum element of the set.
+  inline constexpr bitpos max() const {
+    if (b3 != 0) {
+      return highestBitPosition(b3) + 192;
+    } else if (b2 != 0) {
+      return highestBitPosition(b2) + 128;
+    } else if (b1 != 0) {
+      return highestBitPosition(b1) + 64;
+    } else if (b0 != 0) {
+      return highestBitPosition(b0);
+    } else  {
+      panic("qset4.max(): cannot find any element in the empty set");
+      return 256;
+    }
+  }
+
+  // Return the number of elements in the set.
+  // Said another way, returns the number of bits that have the value 1.
+  inline constexpr bitpos count() const {
+    return countBits(b0) + countBits(b1) + countBits(b2) + countBits(b3);
+  }
+
+  inline constexpr bool operator==(qSet other) const {
+    return ((b0 ^ other.b0) | (b1 ^ other.b1) |
+            (b2 ^ other.b2) | (b3 ^ other.b3)) == 0;
+  }
+
+  inline constexpr bool operator!=(qSet other) const {
+    return !this->operator==(other);
+  }
+
+  // Orders sets by their value as binary numbers (see qset_words.h).
+  inline constexpr bool operator<(qSet other) const {
+    return qset_less<qSet, 4>(*this, other);
+  }
+
+  // Returns a 64-bit hash of the set. Equal sets have equal hashes.
+  inline constexpr uint64_t hash() const {
+    return qset_hash<qSet, 4>(*this);
+  }
+
+  // Fused operations, each one pass over the quadwords (see qset_words.h).
+
+  // Returns whether this set and other have an element in common.
+  inline constexpr bool intersects(qSet other) const {
+    return qset_intersects<qSet, 4>(*this, other);
+  }
+
+  // Returns whether every element of this set is in other.
+  inline constexpr bool is_subset_of(qSet other) const {
+    return !qset_any_andnot<qSet, 4>(*this, other);
+  }
+
+  // Returns whether this set has an element that is not in other.
+  inline constexpr bool any_andnot(qSet other) const {
+    return qset_any_andnot<qSet, 4>(*this, other);
+  }
+
+  // Returns the number of elements in both this set and other.
+  inline bitpos count_and(qSet other) const {
+    return qset_count_and<qSet, 4>(*this, other);
+  }
+
+  // Returns whether count() >= k, without necessarily counting every word.
+  inline bool count_at_least(bitpos k) const {
+    return qset_count_at_least<qSet, 4>(*this, k);
+  }
+
+  // Adds the elements of other to this set, and returns whether that changed
+  // the set.
+  inline bool union_changed(qSet other) {
+    return qset_union_changed<qSet, 4>(this, other);
+  }
+
+  // Returns whether the bit at position pos is set (i.e., whether it is 1).
+  inline constexpr bool test(bitpos pos) const {
+    switch (pos >> 6) {
+      case  0: return (b0 & (1ULL << pos)) != 0;
+      case  1: return (b1 & (1ULL << (pos & 0x3F))) != 0;
+      case  2: return (b2 & (1ULL << (pos & 0x3F))) != 0;
+      case  3: return (b3 & (1ULL << (pos & 0x3F))) != 0;
+      default: return false;
+    }
+  }
+
+  // Returns quadword i of the set (elements 64*i through 64*i+63, with
+  // element 64*i in the low-order bit), or 0 if i is out of range.
+  inline constexpr uint64_t word(bitpos i) const {
+    switch (i) {
+      case  0: return b0;
+      case  1: return b1;
+      case  2: return b2;
+      case  3: return b3;
+      default: return 0;
+    }
+  }
+
+  // Replaces quadword i of the set with value. The caller is responsible for
+  // keeping the unused bits of the last quadword clear.
+  inline qSet& set_word(bitpos i, uint64_t value) {
+    switch (i) {
+      case  0: b0 = value; break;
+      case  1: b1 = value; break;
+      case  2: b2 = value; break;
+      case  3: b3 = value; break;
+      default: throw std::out_of_range("qset.set_word(i)");
+    }
+    return *this;
+  }
+
+  // Returns the k'th smallest element of the set, counting from k = 0.
+  // Panics unless 0 ≤ k < count().
+  inline bitpos select(bitpos k) const {
+    return qset_select<qSet, 4>(*this, k);
+  }
+
+  // Returns the number of elements of the set that are less than pos.
+  inline bitpos rank(bitpos pos) const {
+    return qset_rank<qSet, 4>(*this, pos);
+  }
+
+  // Returns the elements of the set that are also in mask, each renumbered by
+  // its rank in mask (see qset_words.h).
+  inline qSet compress(qSet mask) const {
+    return qset_compress<qSet, 4>(*this, mask);
+  }
+
+  // Returns the inverse of compress(mask): element k of the set becomes the
+  // k'th element of mask.
+  inline qSet expand(qSet mask) const {
+    return qset_expand<qSet, 4>(*this, mask);
+  }
+
+  // Returns the quadword representation of the low-order 64 elements of the
+  // set. Throws std::overflow_error if any high-order elements are present.
+  inline constexpr uint64_t to_ullong() const {
+    if ((b1 | b2 | b3) != 0) {
+      throw std::overflow_error("qset.to_ullong()");
+    }
+    return b0;
+  }
+
+  inline constexpr qSet operator<<(bitpos n) const {
+    return fast_lsh(n).clean();
+  }
+
+  inline constexpr qSet fast_lsh(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.operator<<(): negative shift");
+    } else if (n == 0) {
+      return *this;
+    } else if (n < 64) {
+      return qSet{b0 << n,
+                  (b1 << n) | (b0 >> (64 - n)),
+                  (b2 << n) | (b1 >> (64 - n)),
+                  (b3 << n) | (b2 >> (64 - n))};
+    } else if (n == 64) {
+      return qSet{0, b0, b1, b2};
+    } else if (n < 128) {
+      return qSet{0,
+                  b0 << (n - 64),
+                  (b1 << (n - 64)) | (b0 >> (128 - n)),
+                  (b2 << (n - 64)) | (b1 >> (128 - n))};
+    } else if (n == 128) {
+      return qSet{0, 0, b0, b1};
+    } else if (n < 192) {
+      return qSet{0, 0,
+                  b0 << (n - 128),
+                  (b1 << (n - 128)) | (b0 >> (192 - n))};
+    } else if (n == 192) {
+      return qSet{0, 0, 0, b0};
+    } else if (n < 256) {
+      return qSet{0, 0, 0, b0 << (n - 192)};
+    } else {
+      return qSet{0};
+    }
+  }
+
+  inline constexpr qSet operator>>(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.operator>>(): negative shift");
+    } else if (n == 0) {
+      return *this;
+    } else if (n < 64) {
+      return qSet{(b0 >> n) | (b1 << (64 - n)),
+                  (b1 >> n) | (b2 << (64 - n)),
+                  (b2 >> n) | (b3 << (64 - n)),
+                  b3 >> n};
+    } else if (n == 64) {
+      return qSet{b1, b2, b3, 0};
+    } else if (n < 128) {
+      return qSet{(b1 >> (n - 64)) | (b2 << (128 - n)),
+                  (b2 >> (n - 64)) | (b3 << (128 - n)),
+                  b3 >> (n - 64),
+                  0};
+    } else if (n == 128) {
+      return qSet{b2, b3, 0, 0};
+    } else if (n < 192) {
+      return qSet{(b2 >> (n - 128)) | (b3 << (192 - n)),
+                  b3 >> (n - 128),
+                  0, 0};
+    } else if (n == 192) {
+      return qSet{b3, 0, 0, 0};
+    } else if (n < 256) {
+      return qSet{b3 >> (n - 192), 0, 0, 0};
+    } else {
+      return qSet{0};
+    }
+  }
+
+  // shl<n>(), fast_shl<n>(), and shr<n>() are operator<<(n), fast_lsh(n), and
+  // operator>>(n) for a shift distance known at compile time. Each result
+  // word is computed directly, with none of the range tests of the runtime
+  // versions.
+  template<bitpos n>
+  inline constexpr qSet shl() const {
+    return fast_shl<n>().clean();
+  }
+
+  template<bitpos n>
+  inline constexpr qSet fast_shl() const {
+    static_assert(n >= 0, "qset.fast_shl<n>(): negative shift");
+    return qSet{qset_shl_word<n>(*this, 0),
+                qset_shl_word<n>(*this, 1),
+                qset_shl_word<n>(*this, 2),
+                qset_shl_word<n>(*this, 3)};
+  }
+
+  template<bitpos n>
+  inline constexpr qSet shr() const {
+    static_assert(n >= 0, "qset.shr<n>(): negative shift");
+    return qSet{qset_shr_word<n>(*this, 0),
+                qset_shr_word<n>(*this, 1),
+                qset_shr_word<n>(*this, 2),
+                qset_shr_word<n>(*this, 3)};
+  }
+  // Returns the set with its elements in the opposite order: element i
+  // becomes element BITS-1-i.
+  inline constexpr qSet reverse() const {
+    return qSet{reverseBits(b3), reverseBits(b2),
+                reverseBits(b1), reverseBits(b0)}.template shr<256 - BITS>();
+  }
+
+  // branchless_lsh(n), fast_branchless_lsh(n), and branchless_rsh(n) are
+  // operator<<(n), fast_lsh(n), and operator>>(n) without the branches on n
+  // (see qset_words.h). They are faster when n varies unpredictably.
+  inline qSet branchless_lsh(bitpos n) const {
+    return fast_branchless_lsh(n).clean();
+  }
+
+  inline qSet fast_branchless_lsh(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.fast_branchless_lsh(): negative shift");
+    }
+    return qset_branchless_lsh<qSet, 4>(*this, n);
+  }
+
+  inline qSet branchless_rsh(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.branchless_rsh(): negative shift");
+    }
+    return qset_branchless_rsh<qSet, 4>(*this, n);
+  }
+
+  inline constexpr qSet operator& (qSet other) const {
+    return qSet{b0 & other.b0, b1 & other.b1, b2 & other.b2, b3 & other.b3};
+  }
+
+  inline constexpr qSet operator| (qSet other) const {
+    return qSet{b0 | other.b0, b1 | other.b1, b2 | other.b2, b3 | other.b3};
+  }
+
+  inline constexpr qSet operator^ (qSet other) const {
+    return qSet{b0 ^ other.b0, b1 ^ other.b1, b2 ^ other.b2, b3 ^ other.b3};
+  }
+
+  // Returns the set difference: {x | x in this and x not in other}.
+  inline constexpr qSet operator- (qSet other) const {
+    return qSet{b0 & ~other.b0, b1 & ~other.b1,
+                b2 & ~other.b2, b3 & ~other.b3};
+  }
+
+  inline constexpr qSet operator~ () const {
+    return *this ^ universe();
+  }
+
+  inline constexpr qSet fast_not () const {
+    return qSet{ ~b0, ~b1, ~b2, ~b3 };
+  }
+
+  // MUST NOT IMPLEMENT operator=, or qset won't be POD.
+
+  inline constexpr qSet& operator<<=(bitpos n) {
+    *this = fast_lsh(n).clean();
+    return *this;
+  }
+
+  inline constexpr qSet& fast_lsh_assign(bitpos n) {
+    *this = fast_lsh(n);
+    return *this;
+  }
+
+  inline constexpr qSet& operator>>=(bitpos n) {
+    *this = *this >> n;
+    return *this;
+  }
+
+  inline constexpr qSet& operator&= (qSet other) {
+    b0 &= other.b0;
+    b1 &= other.b1;
+    b2 &= other.b2;
+    b3 &= other.b3;
+    return *this;
+  }
+
+  inline constexpr qSet& operator|= (qSet other) {
+    b0 |= other.b0;
+    b1 |= other.b1;
+    b2 |= other.b2;
+    b3 |= other.b3;
+    return *this;
+  }
+
+  inline constexpr qSet& operator^= (qSet other) {
+    b0 ^= other.b0;
+    b1 ^= other.b1;
+    b2 ^= other.b2;
+    b3 ^= other.b3;
+    return *this;
+  }
+
+  // Removes from this set any elements in other.
+  inline constexpr qSet& operator-= (qSet other) {
+    b0 &= ~other.b0;
+    b1 &= ~other.b1;
+    b2 &= ~other.b2;
+    b3 &= ~other.b3;
+    return *this;
+  }
+
+  // Set all bits.
+  inline constexpr qSet& set() {
+    *this = universe();
+    return *this;
+  }
+
+  // Set the indicated bit.
+  inline constexpr qSet& set(bitpos pos) {
+    switch (pos >> 6) {
+      case  0: b0 |= 1ULL << (pos -  0); break;
+      case  1: b1 |= 1ULL << (pos & 0x3F); break;
+      case  2: b2 |= 1ULL << (pos & 0x3F); break;
+      case  3: b3 |= 1ULL << (pos & 0x3F); break;
+      default: throw std::out_of_range("qset.set(pos)");
+    }
+    return *this;
+  }
+
+  // Set the range of bits [m..n-1].
+  inline constexpr qSet& set(bitpos m, bitpos n) {
+    if (m == n) {
+      return *this;
+    }
+    if (m < 0 || BITS <= m || n < m || BITS < n) {
+      throw std::out_of_range("qset.set(m,n)");
+    }
+    *this |= range_mask(m, n);
+    return *this;
+  }
+
+  // Set bits a, b, c, ....
+  inline constexpr qSet& set(std::initializer_list<bitpos> list) {
+    for (bitpos i : list) {
+      this->set(i);
+    }
+    return *this;
+  }
+
+  // Clear all the bits.
+  inline constexpr qSet& reset() {
+    b0 = 0;
+    b1 = 0;
+    b2 = 0;
+    b3 = 0;
+    return *this;
+  }
+
+  // Clear the indicated bit.
+  inline constexpr qSet& reset(bitpos pos) {
+    switch (pos >> 6) {
+      case  0: b0 &= ~(1ULL << (pos -  0)); break;
+      case  1: b1 &= ~(1ULL << (pos & 0x3F)); break;
+      case  2: b2 &= ~(1ULL << (pos & 0x3F)); break;
+      case  3: b3 &= ~(1ULL << (pos & 0x3F)); break;
+      default: throw std::out_of_range("qset.reset(pos)");
+    }
+    return *this;
+  }
+
+  // Clear the range of bits [m..n-1].
+  inline constexpr qSet& reset(bitpos m, bitpos n) {
+    if (m == n) {
+      return *this;
+    }
+    if (m < 0 || BITS <= m || n < m || BITS < n) {
+      throw std::out_of_range("qset.reset(m,n)");
+    }
+    *this -= range_mask(m, n);
+    return *this;
+  }
+
+  // Clear bits a, b, c, ....
+  inline constexpr qSet& reset(std::initializer_list<bitpos> list) {
+    for (bitpos i : list) {
+      this->reset(i);
+    }
+    return *this;
+  }
+
+  // Toggle all the bits.
+  inline constexpr qSet& flip() {
+    b0 = ~b0;
+    b1 = ~b1;
+    b2 = ~b2;
+    b3 = ~b3;
+    return *this;
+  }
+
+  // Toggle the indicated bit.
+  inline constexpr qSet& flip(bitpos pos) {
+    switch (pos >> 6) {
+      case  0: b0 ^= (1ULL << (pos -  0)); break;
+      case  1: b1 ^= (1ULL << (pos & 0x3F)); break;
+      case  2: b2 ^= (1ULL << (pos & 0x3F)); break;
+      case  3: b3 ^= (1ULL << (pos & 0x3F)); break;
+      default: throw std::out_of_range("qset.flip(pos)");
+    }
+    return *this;
+  }
+
+  // Toggle the range of bits [m..n-1].
+  inline constexpr qSet& flip(bitpos m, bitpos n) {
+    if (m == n) {
+      return *this;
+    }
+    if (m < 0 || BITS <= m || n < m || BITS < n) {
+      throw std::out_of_range("qset.flip(m,n)");
+    }
+    *this ^= range_mask(m, n);
+    return *this;
+  }
+
+  // Toggle bits a, b, c, ....
+  inline constexpr qSet& flip(std::initializer_list<bitpos> list) {
+    for (bitpos i : list) {
+      this->flip(i);
+    }
+    return *this;
+  }
+
+  // Print a representation of the set; for example: {1, 3..5, 8, 10, 12}
+  std::ostream& print(std::ostream &out) {
+    return out << *this;
+  }
+
+  // Return a string representation of the set; for example: {1, 3..5, 8, 12}
+  std::string to_string() const {
+    return ::to_string(*this);
+  }
+
+#ifdef QUADSET_AVX2
+  // Return the set in AVX2 register form (see qset_avx2.h).
+  inline quadvec to_quadvec() const {
+    return avx2_load(b0, b1, b2, b3);
+  }
+
+  // Return the set held in AVX2 register form by v.
+  static inline qSet from_quadvec(quadvec v) {
+    return qSet{avx2_lane<0>(v), avx2_lane<1>(v),
+                avx2_lane<2>(v), avx2_lane<3>(v)};
+  }
+#endif
+
+private:
+  // Returns the set of bits [m..n-1], which must be a nonempty range.
+  // With four quadwords, the range may span up to three quadword boundaries,
+  // so rather than enumerate the cases, each quadword is masked separately.
+  static inline constexpr qSet range_mask(bitpos m, bitpos n) {
+    return qSet{word_range(m, n, 0), word_range(m, n, 1),
+                word_range(m, n, 2), word_range(m, n, 3)};
+  }
+
+  // Returns the bits of [m..n-1] that fall in quadword q.
+  static inline constexpr uint64_t word_range(bitpos m, bitpos n, bitpos q) {
+    return (n <= q * 64 || (q + 1) * 64 <= m) ? 0 :
+      bit_mask(m <= q * 64 ? 0 : m - q * 64,
+               (q + 1) * 64 <= n ? 63 : n - 1 - q * 64);
+  }
+
+};
+
+static_assert (std::is_pod< qset<256,4> >::value, "qset<BITS,4> must be POD");
+
+#endif /* __QSET4_H__ */
@@ -0,0 +1,246 @@
+#ifndef __QSET_AVX2_H__
+#define __QSET_AVX2_H__ 1
+
+// AVX2 kernels for the two-, three- and four-quadword quadsets.
+// =============================================================
+// A qset<BITS,3> or qset<BITS,4> fits in a single 256-bit AVX2 register (a
+// quadvec), with b0 in the lowest 64-bit lane, and a qset<BITS,2> fits in a
+// 128-bit one (a pairvec). The functions below operate on those register
+// forms. The qset2, qset3 and qset4 specializations keep their b0..b3 fields
+// (so they stay POD and aggregate-initializable), and their operators stay
+// scalar: they only provide to_quadvec() and from_quadvec(), or to_pairvec()
+// and from_pairvec() for two quadwords. The kernels are used by
+// cellvec and flood_set (see hex/cellset.h) and their padded counterparts
+// (hex/cellset_padded.h), which keep a whole flood fill in registers, so that
+// the words move to and from the vector registers once per fill rather than
+// once per operator.
+//
+// The kernels are compiled only if QUADSET_AVX2 is defined. quadset.h defines
+// it when the compiler targets AVX2 (e.g., -mavx2 or -march=native), unless
+// QUADSET_NO_AVX2 is defined. Otherwise the scalar code is used.
+//
+// The multi-word shifts are branchless, whether or not the shift distance is
+// known at compile time: a whole-quadword move is a cross-lane permute of
+// 32-bit elements (vpermd), and the remaining 0..63 bits are done with
+// 64-bit lane shifts (vpsllq/vpsrlq), whose counts of 64 or more yield zero.
+// A shift by a constant of less than a quadword (avx2_lsh_small() and
+// avx2_rsh_small(), which the flood fills use) needs only one fixed lane move.
+
+#ifdef QUADSET_AVX2
+#include <immintrin.h>
+
+typedef __m256i quadvec;
+typedef __m128i pairvec;
+
+// Loading a quadset into a register. Unused lanes are zero.
+inline quadvec avx2_load(uint64_t b0, uint64_t b1, uint64_t b2, uint64_t b3) {
+  return _mm256_set_epi64x(b3, b2, b1, b0);
+}
+
+inline pairvec avx2_load(uint64_t b0, uint64_t b1) {
+  return _mm_set_epi64x(b1, b0);
+}
+
+// Return the 64-bit lane i (0 ≤ i < 4, or i < 2 for a pairvec) of v.
+template<int i>
+inline uint64_t avx2_lane(quadvec v) {
+  return _mm256_extract_epi64(v, i);
+}
+
+template<int i>
+inline uint64_t avx2_lane(pairvec v) {
+  return _mm_extract_epi64(v, i);
+}
+
+// Return the intersection, the union, and the symmetric difference of a and b.
+inline quadvec avx2_and(quadvec a, quadvec b) {
+  return _mm256_and_si256(a, b);
+}
+
+inline pairvec avx2_and(pairvec a, pairvec b) {
+  return _mm_and_si128(a, b);
+}
+
+inline quadvec avx2_or(quadvec a, quadvec b) {
+  return _mm256_or_si256(a, b);
+}
+
+inline pairvec avx2_or(pairvec a, pairvec b) {
+  return _mm_or_si128(a, b);
+}
+
+inline quadvec avx2_xor(quadvec a, quadvec b) {
+  return _mm256_xor_si256(a, b);
+}
+
+inline pairvec avx2_xor(pairvec a, pairvec b) {
+  return _mm_xor_si128(a, b);
+}
+
+// Return the lanes of v moved up by q lanes (toward b3), with zeros shifted
+// in. Requires 0 ≤ q; q ≥ 4 yields zero.
+inline quadvec avx2_lane_up(quadvec v, int q) {
+  const __m256i index = _mm256_sub_epi32(
+      _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(2 * q));
+  const __m256i keep = _mm256_cmpgt_epi32(index, _mm256_set1_epi32(-1));
+  return _mm256_and_si256(_mm256_permutevar8x32_epi32(v, index), keep);
+}
+
+// Return the lanes of v moved down by q lanes (toward b0), with zeros shifted
+// in. Requires 0 ≤ q; q ≥ 4 yields zero.
+inline quadvec avx2_lane_down(quadvec v, int q) {
+  const __m256i index = _mm256_add_epi32(
+      _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(2 * q));
+  const __m256i keep = _mm256_cmpgt_epi32(_mm256_set1_epi32(8), index);
+  return _mm256_and_si256(_mm256_permutevar8x32_epi32(v, index), keep);
+}
+
+// Return v shifted left (toward b3) by n bits; bits shifted past the top of
+// lane 3 are lost. Requires 0 ≤ n.
+inline quadvec avx2_lsh(quadvec v, int n) {
+  const int q = n >> 6;
+  const __m128i bits = _mm_cvtsi32_si128(n & 0x3F);
+  const __m128i carryBits = _mm_cvtsi32_si128(64 - (n & 0x3F));
+  return _mm256_or_si256(
+      _mm256_sll_epi64(avx2_lane_up(v, q), bits),
+      _mm256_srl_epi64(avx2_lane_up(v, q + 1), carryBits));
+}
+
+// Return v shifted right (toward b0) by n bits. Requires 0 ≤ n.
+inline quadvec avx2_rsh(quadvec v, int n) {
+  const int q = n >> 6;
+  const __m128i bits = _mm_cvtsi32_si128(n & 0x3F);
+  const __m128i carryBits = _mm_cvtsi32_si128(64 - (n & 0x3F));
+  return _mm256_or_si256(
+      _mm256_srl_epi64(avx2_lane_down(v, q), bits),
+      _mm256_sll_epi64(avx2_lane_down(v, q + 1), carryBits));
+}
+
+// Return the lanes of v moved up by one lane, with a zero lane 0. Unlike
+// avx2_lane_up(v, 1), this is a permute with an immediate and a blend; for a
+// pairvec, it is a byte shift.
+inline quadvec avx2_lane_up1(quadvec v) {
+  return _mm256_blend_epi32(_mm256_permute4x64_epi64(v, 0x90),
+                            _mm256_setzero_si256(), 0x03);
+}
+
+inline pairvec avx2_lane_up1(pairvec v) {
+  return _mm_slli_si128(v, 8);
+}
+
+// Return the lanes of v moved down by one lane, with a zero top lane.
+inline quadvec avx2_lane_down1(quadvec v) {
+  return _mm256_blend_epi32(_mm256_permute4x64_epi64(v, 0xF9),
+                            _mm256_setzero_si256(), 0xC0);
+}
+
+inline pairvec avx2_lane_down1(pairvec v) {
+  return _mm_srli_si128(v, 8);
+}
+
+// Return v shifted left by n bits, for a constant 0 < n < 64; bits shifted
+// past the top lane are lost.
+template<int n>
+inline quadvec avx2_lsh_small(quadvec v) {
+  static_assert(0 < n && n < 64, "avx2_lsh_small: n must be 1 to 63");
+  return _mm256_or_si256(_mm256_slli_epi64(v, n),
+                         _mm256_srli_epi64(avx2_lane_up1(v), 64 - n));
+}
+
+template<int n>
+inline pairvec avx2_lsh_small(pairvec v) {
+  static_assert(0 < n && n < 64, "avx2_lsh_small: n must be 1 to 63");
+  return _mm_or_si128(_mm_slli_epi64(v, n),
+                      _mm_srli_epi64(avx2_lane_up1(v), 64 - n));
+}
+
+// Return v shifted right by n bits, for a constant 0 < n < 64.
+template<int n>
+inline quadvec avx2_rsh_small(quadvec v) {
+  static_assert(0 < n && n < 64, "avx2_rsh_small: n must be 1 to 63");
+  return _mm256_or_si256(_mm256_srli_epi64(v, n),
+                         _mm256_slli_epi64(avx2_lane_down1(v), 64 - n));
+}
+
+template<int n>
+inline pairvec avx2_rsh_small(pairvec v) {
+  static_assert(0 < n && n < 64, "avx2_rsh_small: n must be 1 to 63");
+  return _mm_or_si128(_mm_srli_epi64(v, n),
+                      _mm_slli_epi64(avx2_lane_down1(v), 64 - n));
+}
+
+// Return true iff no bit of v is set.
+inline bool avx2_none(quadvec v) {
+  return _mm256_testz_si256(v, v);
+}
+
+inline bool avx2_none(pairvec v) {
+  return _mm_testz_si128(v, v);
+}
+
+// Return true iff a and b have no bits in common.
+inline bool avx2_disjoint(quadvec a, quadvec b) {
+  return _mm256_testz_si256(a, b);
+}
+
+inline bool avx2_disjoint(pairvec a, pairvec b) {
+  return _mm_testz_si128(a, b);
+}
+
+// Return true iff every bit of a is also set in b.
+inline bool avx2_subset(quadvec a, quadvec b) {
+  return _mm256_testc_si256(b, a);
+}
+
+inline bool avx2_subset(pairvec a, pairvec b) {
+  return _mm_testc_si128(b, a);
+}
+
+// A dualvec holds two pairvecs, the first in the low 128 bits and the second
+// in the high 128 bits, so that an operation on it does both. Its shifts shift
+// each half on its own: the AVX2 byte shifts stay within the 128-bit halves.
+struct dualvec {
+  __m256i v;
+};
+
+inline dualvec avx2_dual(pairvec first, pairvec second) {
+  return dualvec{ _mm256_set_m128i(second, first) };
+}
+
+inline pairvec avx2_first(dualvec d) {
+  return _mm256_castsi256_si128(d.v);
+}
+
+inline pairvec avx2_second(dualvec d) {
+  return _mm256_extracti128_si256(d.v, 1);
+}
+
+inline dualvec avx2_and(dualvec a, dualvec b) {
+  return dualvec{ _mm256_and_si256(a.v, b.v) };
+}
+
+inline dualvec avx2_or(dualvec a, dualvec b) {
+  return dualvec{ _mm256_or_si256(a.v, b.v) };
+}
+
+template<int n>
+inline dualvec avx2_lsh_small(dualvec d) {
+  static_assert(0 < n && n < 64, "avx2_lsh_small: n must be 1 to 63");
+  return dualvec{ _mm256_or_si256(_mm256_slli_epi64(d.v, n),
+      _mm256_srli_epi64(_mm256_bslli_epi128(d.v, 8), 64 - n)) };
+}
+
+template<int n>
+inline dualvec avx2_rsh_small(dualvec d) {
+  static_assert(0 < n && n < 64, "avx2_rsh_small: n must be 1 to 63");
+  return dualvec{ _mm256_or_si256(_mm256_srli_epi64(d.v, n),
+      _mm256_slli_epi64(_mm256_bsrli_epi128(d.v, 8), 64 - n)) };
+}
+
+// Return true iff every bit of a is also set in b, in both halves.
+inline bool avx2_subset(dualvec a, dualvec b) {
+  return _mm256_testc_si256(b.v, a.v);
+}
+
+#endif /* QUADSET_AVX2 */
+#endif /* __QSET_AVX2_H__ */
@@ -0,0 +1,343 @@
+#ifndef __QSET_WORDS_H__
+#define __QSET_WORDS_H__ 1
+#include <stdint.h>
+#include "../panic/panic.h"
+#include "bitops.h"
+
+// Word-at-a-time algorithms shared by the qset specializations and the
+// generic qset template. Each takes the qset type and its number of
+// quadwords as template arguments, and accesses the set only through its
+// word() and set_word() methods.
+
+
+// qset_portable_bits holds the word operations that qset_select,
+// qset_compress, and qset_expand are built on, as chosen by bitops.h.
+struct qset_portable_bits {
+  static inline int select(uint64_t q, int k) {
+    return selectBitPosition(q, k);
+  }
+  static inline uint64_t extract(uint64_t q, uint64_t mask) {
+    return extractBits(q, mask);
+  }
+  static inline uint64_t deposit(uint64_t q, uint64_t mask) {
+    return depositBits(q, mask);
+  }
+};
+
+#ifdef BITOPS_DISPATCH_BMI2
+// qset_bmi2_bits holds the same operations, built on PDEP and PEXT. Call them
+// only from code compiled with BITOPS_BMI2, when bitopsFastBmi2 is set.
+struct qset_bmi2_bits {
+  BITOPS_BMI2 static inline int select(uint64_t q, int k) {
+    return __builtin_ctzll(_pdep_u64(1ULL << k, q));
+  }
+  BITOPS_BMI2 static inline uint64_t extract(uint64_t q, uint64_t mask) {
+    return _pext_u64(q, mask);
+  }
+  BITOPS_BMI2 static inline uint64_t deposit(uint64_t q, uint64_t mask) {
+    return _pdep_u64(q, mask);
+  }
+};
+#endif
+
+// qset_select_with is qset_select, built on the word operations of Bits.
+template<class qSet, bitpos QUADWORDS, class Bits>
+inline bitpos qset_select_with(qSet set, bitpos k) {
+  if (k >= 0) {
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      uint64_t w = set.word(i);
+      bitpos c = countBits(w);
+      if (k < c) {
+        return 64 * i + Bits::select(w, k);
+      }
+      k -= c;
+    }
+  }
+  panic("qset.select(k): k is out of range");
+  return 64 * QUADWORDS;
+}
+
+// qset_compress_with is qset_compress, built on the word operations of Bits.
+template<class qSet, bitpos QUADWORDS, class Bits>
+inline qSet qset_compress_with(qSet set, qSet mask) {
+  qSet result = {0};
+  bitpos offset = 0;
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    const uint64_t m = mask.word(i);
+    const uint64_t packed = Bits::extract(set.word(i), m);
+    const bitpos j = offset >> 6;
+    const int bits = offset & 0x3F;
+    result.set_word(j, result.word(j) | packed << bits);
+    if (bits != 0 && j + 1 < QUADWORDS) {
+      result.set_word(j + 1, result.word(j + 1) | packed >> (64 - bits));
+    }
+    offset += countBits(m);
+  }
+  return result;
+}
+
+// qset_expand_with is qset_expand, built on the word operations of Bits.
+template<class qSet, bitpos QUADWORDS, class Bits>
+inline qSet qset_expand_with(qSet set, qSet mask) {
+  qSet result = {0};
+  bitpos offset = 0;
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    const uint64_t m = mask.word(i);
+    const bitpos j = offset >> 6;
+    const int bits = offset & 0x3F;
+    uint64_t source = set.word(j) >> bits;
+    if (bits != 0) {
+      source |= set.word(j + 1) << (64 - bits);
+    }
+    result.set_word(i, Bits::deposit(source, m));
+    offset += countBits(m);
+  }
+  return result;
+}
+
+#ifdef BITOPS_DISPATCH_BMI2
+// The versions of qset_select, qset_compress, and qset_expand that use BMI2,
+// compiled for a CPU that has it. GCC does not inline the qset_bmi2_bits
+// operations through the portable template by itself, so flatten makes it.
+template<class qSet, bitpos QUADWORDS>
+BITOPS_BMI2 __attribute__((flatten))
+bitpos qset_select_bmi2(qSet set, bitpos k) {
+  return qset_select_with<qSet, QUADWORDS, qset_bmi2_bits>(set, k);
+}
+
+template<class qSet, bitpos QUADWORDS>
+BITOPS_BMI2 __attribute__((flatten))
+qSet qset_compress_bmi2(qSet set, qSet mask) {
+  return qset_compress_with<qSet, QUADWORDS, qset_bmi2_bits>(set, mask);
+}
+
+template<class qSet, bitpos QUADWORDS>
+BITOPS_BMI2 __attribute__((flatten))
+qSet qset_expand_bmi2(qSet set, qSet mask) {
+  return qset_expand_with<qSet, QUADWORDS, qset_bmi2_bits>(set, mask);
+}
+#endif
+
+// qset_select returns the k'th smallest element of set, counting from k = 0.
+// Panics unless 0 ≤ k < set.count(). Like qset_compress and qset_expand, it
+// calls its BMI2 version if bitopsFastBmi2 is set (see bitops.h).
+template<class qSet, bitpos QUADWORDS>
+inline bitpos qset_select(qSet set, bitpos k) {
+#ifdef BITOPS_DISPATCH_BMI2
+  if (bitopsFastBmi2) {
+    return qset_select_bmi2<qSet, QUADWORDS>(set, k);
+  }
+#endif
+  return qset_select_with<qSet, QUADWORDS, qset_portable_bits>(set, k);
+}
+
+// qset_rank returns the number of elements of set that are less than pos.
+template<class qSet, bitpos QUADWORDS>
+inline bitpos qset_rank(qSet set, bitpos pos) {
+  bitpos result = 0;
+  for (bitpos i = 0; i < QUADWORDS && 64 * i < pos; ++i) {
+    uint64_t w = set.word(i);
+    if (pos - 64 * i < 64) {
+      w &= (1ULL << (pos - 64 * i)) - 1;
+    }
+    result += countBits(w);
+  }
+  return result;
+}
+
+// qset_compress returns the elements of set that are also in mask, each
+// renumbered by its rank in mask. For example, if mask is {3, 5, 9} and set
+// is {1, 5, 9}, the result is {1, 2}.
+template<class qSet, bitpos QUADWORDS>
+inline qSet qset_compress(qSet set, qSet mask) {
+#ifdef BITOPS_DISPATCH_BMI2
+  if (bitopsFastBmi2) {
+    return qset_compress_bmi2<qSet, QUADWORDS>(set, mask);
+  }
+#endif
+  return qset_compress_with<qSet, QUADWORDS, qset_portable_bits>(set, mask);
+}
+
+// qset_expand is the inverse of qset_compress: it returns the set whose
+// elements are the k'th elements of mask, for each k in set. For example, if
+// mask is {3, 5, 9} and set is {1, 2}, the result is {5, 9}. Elements of set
+// that are not less than mask.count() are ignored.
+template<class qSet, bitpos QUADWORDS>
+inline qSet qset_expand(qSet set, qSet mask) {
+#ifdef BITOPS_DISPATCH_BMI2
+  if (bitopsFastBmi2) {
+    return qset_expand_bmi2<qSet, QUADWORDS>(set, mask);
+  }
+#endif
+  return qset_expand_with<qSet, QUADWORDS, qset_portable_bits>(set, mask);
+}
+
+// qset_hash_mix scrambles the bits of h, so that every input bit affects
+// every output bit. It is the 64-bit finalizer of MurmurHash3.
+inline constexpr uint64_t qset_hash_mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// qset_hash returns a 64-bit hash of the quadwords of set, by a multiply and
+// xorshift per quadword and one qset_hash_mix at the end. Sets that are equal
+// (i.e., that have clean, equal quadwords) have equal hashes.
+template<class qSet, bitpos QUADWORDS>
+inline constexpr uint64_t qset_hash(qSet set) {
+  uint64_t h = QUADWORDS;
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    h = (h ^ set.word(i)) * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 32;
+  }
+  return qset_hash_mix(h);
+}
+
+// qset_less returns whether a comes before b when each set is read as a
+// binary number, with element 0 as the low-order bit. That is a total order,
+// and it agrees with operator==.
+template<class qSet, bitpos QUADWORDS>
+inline constexpr bool qset_less(qSet a, qSet b) {
+  for (bitpos i = QUADWORDS - 1; i > 0; --i) {
+    if (a.word(i) != b.word(i)) {
+      return a.word(i) < b.word(i);
+    }
+  }
+  return a.word(0) < b.word(0);
+}
+
+// qset_shl_word returns quadword i of set shifted left by n, a distance known
+// at compile time, without clearing the unused bits. With n and i constant,
+// it reduces to at most two word shifts and an or. Requires 0 ≤ n.
+template<bitpos n, class qSet>
+inline constexpr uint64_t qset_shl_word(qSet set, bitpos i) {
+  return n % 64 == 0 ? set.word(i - n / 64) :
+    set.word(i - n / 64) << (n % 64) |
+    set.word(i - n / 64 - 1) >> ((64 - n % 64) % 64);
+}
+
+// qset_shr_word returns quadword i of set shifted right by n, a distance
+// known at compile time. Requires 0 ≤ n.
+template<bitpos n, class qSet>
+inline constexpr uint64_t qset_shr_word(qSet set, bitpos i) {
+  return n % 64 == 0 ? set.word(i + n / 64) :
+    set.word(i + n / 64) >> (n % 64) |
+    set.word(i + n / 64 + 1) << ((64 - n % 64) % 64);
+}
+
+// qset_branchless_lsh returns set shifted left by n bits, without clearing the
+// unused bits, and qset_branchless_rsh returns set shifted right by n bits.
+// Unlike the shift operators, they do not branch on n, so their speed does
+// not depend on how predictable the shift distances are. They work like a
+// barrel shifter: a funnel shift of every word by n%64 bits, then one stage
+// per bit of the whole-word distance n/64, each of which either moves the
+// words along or leaves them in place, chosen by a mask rather than a branch.
+// A distance of 64*QUADWORDS or more clears every word. Requires 0 ≤ n.
+template<class qSet, bitpos QUADWORDS>
+inline qSet qset_branchless_lsh(qSet set, bitpos n) {
+  const int bits = n & 0x3F;
+  uint64_t w[QUADWORDS];
+  for (bitpos i = QUADWORDS - 1; i >= 0; --i) {
+    // (x >> 1) >> (63 - bits) is x >> (64 - bits), but is 0 when bits is 0.
+    w[i] = set.word(i) << bits | (set.word(i - 1) >> 1) >> (63 - bits);
+  }
+  for (bitpos step = 1; step < QUADWORDS; step <<= 1) {
+    const uint64_t move = -uint64_t((n >> 6) & step ? 1 : 0);
+    for (bitpos i = QUADWORDS - 1; i >= 0; --i) {
+      const uint64_t moved = i >= step ? w[i - step] : 0;
+      w[i] = (moved & move) | (w[i] & ~move);
+    }
+  }
+  const uint64_t keep = -uint64_t(n < 64 * QUADWORDS ? 1 : 0);
+  qSet result = {0};
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    result.set_word(i, w[i] & keep);
+  }
+  return result;
+}
+
+template<class qSet, bitpos QUADWORDS>
+inline qSet qset_branchless_rsh(qSet set, bitpos n) {
+  const int bits = n & 0x3F;
+  uint64_t w[QUADWORDS];
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    w[i] = set.word(i) >> bits | (set.word(i + 1) << 1) << (63 - bits);
+  }
+  for (bitpos step = 1; step < QUADWORDS; step <<= 1) {
+    const uint64_t move = -uint64_t((n >> 6) & step ? 1 : 0);
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      const uint64_t moved = i + step < QUADWORDS ? w[i + step] : 0;
+      w[i] = (moved & move) | (w[i] & ~move);
+    }
+  }
+  const uint64_t keep = -uint64_t(n < 64 * QUADWORDS ? 1 : 0);
+  qSet result = {0};
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    result.set_word(i, w[i] & keep);
+  }
+  return result;
+}
+
+// The fused predicates below each make one pass over the quadwords of their
+// arguments, instead of building an intermediate set and then reducing it.
+
+// qset_intersects returns whether a and b have an element in common, i.e.,
+// (a & b).any().
+template<class qSet, bitpos QUADWORDS>
+inline constexpr bool qset_intersects(qSet a, qSet b) {
+  uint64_t common = 0;
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    common |= a.word(i) & b.word(i);
+  }
+  return common != 0;
+}
+
+// qset_any_andnot returns whether a has an element that is not in b, i.e.,
+// (a - b).any(). Its negation says whether a is a subset of b.
+template<class qSet, bitpos QUADWORDS>
+inline constexpr bool qset_any_andnot(qSet a, qSet b) {
+  uint64_t extra = 0;
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    extra |= a.word(i) & ~b.word(i);
+  }
+  return extra != 0;
+}
+
+// qset_count_and returns (a & b).count().
+template<class qSet, bitpos QUADWORDS>
+inline bitpos qset_count_and(qSet a, qSet b) {
+  bitpos result = 0;
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    result += countBits(a.word(i) & b.word(i));
+  }
+  return result;
+}
+
+// qset_count_at_least returns whether set.count() >= k, stopping as soon as k
+// elements have been counted.
+template<class qSet, bitpos QUADWORDS>
+inline bool qset_count_at_least(qSet set, bitpos k) {
+  for (bitpos i = 0; i < QUADWORDS && k > 0; ++i) {
+    k -= countBits(set.word(i));
+  }
+  return k <= 0;
+}
+
+// qset_union_changed replaces *set with *set | other, and returns whether
+// that added any elements.
+template<class qSet, bitpos QUADWORDS>
+inline bool qset_union_changed(qSet *set, qSet other) {
+  uint64_t added = 0;
+  for (bitpos i = 0; i < QUADWORDS; ++i) {
+    const uint64_t w = set->word(i);
+    const uint64_t merged = w | other.word(i);
+    added |= merged ^ w;
+    set->set_word(i, merged);
+  }
+  return added != 0;
+}
+
+#endif /* __QSET_WORDS_H__ */
@@ -0,0 +1,585 @@
+#ifndef __QSETN_H__
+#define __QSETN_H__
+#include <stdint.h>
+#include <stdexcept>
+#include <utility>
+#include "quadset.h"
+#include "bitops.h"
+#include "qset_words.h"
+
+// This is the primary qset<BITS,QUADWORDS> template: a bitset that holds an
+// arbitrary number of quadwords. It is used for the capacities that have no
+// hand-written specialization -- i.e., 5 or 6 quadwords (257 through 384
+// bits), which is enough for boards up to 19×19.
+//
+// Operations that produce a set are written as a pack expansion over the
+// word indexes 0..QUADWORDS-1 (see the `words` index sequence), so they are
+// unrolled at compile time, and each result word is computed directly into the
+// aggregate initializer. Once inlined, a shift by a constant amount reduces to
+// the same straight-line word operations that qset1.h through qset4.h spell
+// out by hand. Don't be tempted to fill in a local result array with a loop
+// instead: GCC vectorizes the resulting stores and reloads, and the
+// store-forwarding stalls make fast_neighbors() several times slower.
+//
+// If QUADSET_GENERIC is defined, the hand-written specializations are omitted
+// and this template is used for every capacity, which makes it possible to
+// compare the two on the same workload.
+
+template<bitpos BITS, bitpos QUADWORDS>
+class qset {
+public:
+  uint64_t b[QUADWORDS];
+
+  static_assert (1 <= QUADWORDS && QUADWORDS <= 6,
+      "qset<BITS,QUADWORDS>: QUADWORDS must be in 1..6");
+  static_assert (64 * (QUADWORDS - 1) < BITS && BITS <= 64 * QUADWORDS,
+      "qset<BITS,QUADWORDS>: BITS does not match QUADWORDS");
+
+  typedef qset<BITS,QUADWORDS> qSet;
+  typedef std::make_index_sequence<QUADWORDS> words;
+
+  static inline constexpr qSet from_ullong(uint64_t val) {
+    return qSet{val};
+  }
+
+  static inline constexpr qSet make() {
+    return qSet{0};
+  }
+
+  static inline constexpr qSet make(std::initializer_list<bitpos> list) {
+    qSet result = {0};
+    for (int i : list) {
+      result.set(i);
+    }
+    return result;
+  }
+
+  static inline constexpr qSet range(bitpos m, bitpos n) {
+    qSet result = {0};
+    result.set(m, n);
+    return result;
+  }
+
+  static inline constexpr qSet universe() {
+    return universe(words());
+  }
+
+  // Clear any set bits in the unused part of the storage.  This method exists
+  // for use as needed after fast_lsh(), fast_lsh_assign(), and/or fast_not().
+  inline constexpr qSet clean() {
+    return clean(words());
+  }
+
+  inline constexpr bitpos size() { return BITS; }
+
+  // Return true iff the set is nonempty.
+  inline constexpr bool any() const {
+    uint64_t bits = 0;
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      bits |= b[i];
+    }
+    return bits != 0;
+  }
+
+  // Return true iff the set is empty.
+  inline constexpr bool none() const {
+    return !any();
+  }
+
+  // Return true iff all the bits in the set are 1.
+  inline constexpr bool all() const {
+    return this->operator==(universe());
+  }
+
+  // Return the minimum element of the set.
+  inline constexpr bitpos min() const {
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      if (b[i] != 0) {
+        return lowestBitPosition(b[i]) + 64 * i;
+      }
+    }
+    panic("qset.min(): cannot find any element in the empty set");
+    return 64 * QUADWORDS;
+  }
+
+  // Return the maximum element of the set.
+  inline constexpr bitpos max() const {
+    for (bitpos i = QUADWORDS - 1; i >= 0; --i) {
+      if (b[i] != 0) {
+        return highestBitPosition(b[i]) + 64 * i;
+      }
+    }
+    panic("qset.max(): cannot find any element in the empty set");
+    return 64 * QUADWORDS;
+  }
+
+  // Return the number of elements in the set.
+  // Said another way, returns the number of bits that have the value 1.
+  inline constexpr bitpos count() const {
+    bitpos sum = 0;
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      sum += countBits(b[i]);
+    }
+    return sum;
+  }
+
+  inline constexpr bool operator==(qSet other) const {
+    uint64_t diff = 0;
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      diff |= b[i] ^ other.b[i];
+    }
+    return diff == 0;
+  }
+
+  inline constexpr bool operator!=(qSet other) const {
+    return !this->operator==(other);
+  }
+
+  // Orders sets by their value as binary numbers (see qset_words.h).
+  inline constexpr bool operator<(qSet other) const {
+    return qset_less<qSet, QUADWORDS>(*this, other);
+  }
+
+  // Returns a 64-bit hash of the set. Equal sets have equal hashes.
+  inline constexpr uint64_t hash() const {
+    return qset_hash<qSet, QUADWORDS>(*this);
+  }
+
+  // Fused operations, each one pass over the quadwords (see qset_words.h).
+
+  // Returns whether this set and other have an element in common.
+  inline constexpr bool intersects(qSet other) const {
+    return qset_intersects<qSet, QUADWORDS>(*this, other);
+  }
+
+  // Returns whether every element of this set is in other.
+  inline constexpr bool is_subset_of(qSet other) const {
+    return !qset_any_andnot<qSet, QUADWORDS>(*this, other);
+  }
+
+  // Returns whether this set has an element that is not in other.
+  inline constexpr bool any_andnot(qSet other) const {
+    return qset_any_andnot<qSet, QUADWORDS>(*this, other);
+  }
+
+  // Returns the number of elements in both this set and other.
+  inline bitpos count_and(qSet other) const {
+    return qset_count_and<qSet, QUADWORDS>(*this, other);
+  }
+
+  // Returns whether count() >= k, without necessarily counting every word.
+  inline bool count_at_least(bitpos k) const {
+    return qset_count_at_least<qSet, QUADWORDS>(*this, k);
+  }
+
+  // Adds the elements of other to this set, and returns whether that changed
+  // the set.
+  inline bool union_changed(qSet other) {
+    return qset_union_changed<qSet, QUADWORDS>(this, other);
+  }
+
+  // Returns whether the bit at position pos is set (i.e., whether it is 1).
+  inline constexpr bool test(bitpos pos) const {
+    if (pos < 0 || 64 * QUADWORDS <= pos) {
+      return false;
+    }
+    return (b[pos >> 6] & (1ULL << (pos & 0x3F))) != 0;
+  }
+
+  // Returns quadword i of the set (elements 64*i through 64*i+63, with
+  // element 64*i in the low-order bit), or 0 if i is out of range.
+  inline constexpr uint64_t word(bitpos i) const {
+    return 0 <= i && i < QUADWORDS ? b[i] : 0;
+  }
+
+  // Replaces quadword i of the set with value. The caller is responsible for
+  // keeping the unused bits of the last quadword clear.
+  inline qSet& set_word(bitpos i, uint64_t value) {
+    if (i < 0 || QUADWORDS <= i) {
+      throw std::out_of_range("qset.set_word(i)");
+    }
+    b[i] = value;
+    return *this;
+  }
+
+  // Returns the k'th smallest element of the set, counting from k = 0.
+  // Panics unless 0 ≤ k < count().
+  inline bitpos select(bitpos k) const {
+    return qset_select<qSet, QUADWORDS>(*this, k);
+  }
+
+  // Returns the number of elements of the set that are less than pos.
+  inline bitpos rank(bitpos pos) const {
+    return qset_rank<qSet, QUADWORDS>(*this, pos);
+  }
+
+  // Returns the elements of the set that are also in mask, each renumbered by
+  // its rank in mask (see qset_words.h).
+  inline qSet compress(qSet mask) const {
+    return qset_compress<qSet, QUADWORDS>(*this, mask);
+  }
+
+  // Returns the inverse of compress(mask): element k of the set becomes the
+  // k'th element of mask.
+  inline qSet expand(qSet mask) const {
+    return qset_expand<qSet, QUADWORDS>(*this, mask);
+  }
+
+  // Returns the quadword representation of the low-order 64 elements of the
+  // set. Throws std::overflow_error if any high-order elements are present.
+  inline constexpr uint64_t to_ullong() const {
+    for (bitpos i = 1; i < QUADWORDS; ++i) {
+      if (b[i] != 0) {
+        throw std::overflow_error("qset.to_ullong()");
+      }
+    }
+    return b[0];
+  }
+
+  inline constexpr qSet operator<<(bitpos n) const {
+    return fast_lsh(n).clean();
+  }
+
+  inline constexpr qSet fast_lsh(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.operator<<(): negative shift");
+    }
+    return fast_lsh(n, words());
+  }
+
+  inline constexpr qSet operator>>(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.operator>>(): negative shift");
+    }
+    return rsh(n, words());
+  }
+
+  // shl<n>(), fast_shl<n>(), and shr<n>() are operator<<(n), fast_lsh(n), and
+  // operator>>(n) for a shift distance known at compile time. Each result
+  // word is computed directly, with none of the range tests of the runtime
+  // versions.
+  template<bitpos n>
+  inline constexpr qSet shl() const {
+    return fast_shl<n>().clean();
+  }
+
+  template<bitpos n>
+  inline constexpr qSet fast_shl() const {
+    static_assert(n >= 0, "qset.fast_shl<n>(): negative shift");
+    return fast_shl<n>(words());
+  }
+
+  template<bitpos n>
+  inline constexpr qSet shr() const {
+    static_assert(n >= 0, "qset.shr<n>(): negative shift");
+    return shr<n>(words());
+  }
+  // Returns the set with its elements in the opposite order: element i
+  // becomes element BITS-1-i.
+  inline constexpr qSet reverse() const {
+    return reversed_words(words()).template shr<64 * QUADWORDS - BITS>();
+  }
+
+  // branchless_lsh(n), fast_branchless_lsh(n), and branchless_rsh(n) are
+  // operator<<(n), fast_lsh(n), and operator>>(n) without the branches on n
+  // (see qset_words.h). They are faster when n varies unpredictably.
+  inline qSet branchless_lsh(bitpos n) const {
+    return fast_branchless_lsh(n).clean();
+  }
+
+  inline qSet fast_branchless_lsh(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.fast_branchless_lsh(): negative shift");
+    }
+    return qset_branchless_lsh<qSet, QUADWORDS>(*this, n);
+  }
+
+  inline qSet branchless_rsh(bitpos n) const {
+    if (n < 0) {
+      throw std::out_of_range("qset.branchless_rsh(): negative shift");
+    }
+    return qset_branchless_rsh<qSet, QUADWORDS>(*this, n);
+  }
+
+  inline constexpr qSet operator& (qSet other) const {
+    return and_(other, words());
+  }
+
+  inline constexpr qSet operator| (qSet other) const {
+    return or_(other, words());
+  }
+
+  inline constexpr qSet operator^ (qSet other) const {
+    return xor_(other, words());
+  }
+
+  // Returns the set difference: {x | x in this and x not in other}.
+  inline constexpr qSet operator- (qSet other) const {
+    return andnot_(other, words());
+  }
+
+  inline constexpr qSet operator~ () const {
+    return *this ^ universe();
+  }
+
+  inline constexpr qSet fast_not () const {
+    return not_(words());
+  }
+
+  // MUST NOT IMPLEMENT operator=, or qset won't be POD.
+
+  inline constexpr qSet& operator<<=(bitpos n) {
+    *this = fast_lsh(n).clean();
+    return *this;
+  }
+
+  inline constexpr qSet& fast_lsh_assign(bitpos n) {
+    *this = fast_lsh(n);
+    return *this;
+  }
+
+  inline constexpr qSet& operator>>=(bitpos n) {
+    *this = *this >> n;
+    return *this;
+  }
+
+  inline constexpr qSet& operator&= (qSet other) {
+    *this = *this & other;
+    return *this;
+  }
+
+  inline constexpr qSet& operator|= (qSet other) {
+    *this = *this | other;
+    return *this;
+  }
+
+  inline constexpr qSet& operator^= (qSet other) {
+    *this = *this ^ other;
+    return *this;
+  }
+
+  // Removes from this set any elements in other.
+  inline constexpr qSet& operator-= (qSet other) {
+    *this = *this - other;
+    return *this;
+  }
+
+  // Set all bits.
+  inline constexpr qSet& set() {
+    *this = universe();
+    return *this;
+  }
+
+  // Set the indicated bit.
+  inline constexpr qSet& set(bitpos pos) {
+    if (pos < 0 || 64 * QUADWORDS <= pos) {
+      throw std::out_of_range("qset.set(pos)");
+    }
+    b[pos >> 6] |= 1ULL << (pos & 0x3F);
+    return *this;
+  }
+
+  // Set the range of bits [m..n-1].
+  inline constexpr qSet& set(bitpos m, bitpos n) {
+    if (m == n) {
+      return *this;
+    }
+    if (m < 0 || BITS <= m || n < m || BITS < n) {
+      throw std::out_of_range("qset.set(m,n)");
+    }
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      b[i] |= word_range(m, n, i);
+    }
+    return *this;
+  }
+
+  // Set bits a, b, c, ....
+  inline constexpr qSet& set(std::initializer_list<bitpos> list) {
+    for (bitpos i : list) {
+      this->set(i);
+    }
+    return *this;
+  }
+
+  // Clear all the bits.
+  inline constexpr qSet& reset() {
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      b[i] = 0;
+    }
+    return *this;
+  }
+
+  // Clear the indicated bit.
+  inline constexpr qSet& reset(bitpos pos) {
+    if (pos < 0 || 64 * QUADWORDS <= pos) {
+      throw std::out_of_range("qset.reset(pos)");
+    }
+    b[pos >> 6] &= ~(1ULL << (pos & 0x3F));
+    return *this;
+  }
+
+  // Clear the range of bits [m..n-1].
+  inline constexpr qSet& reset(bitpos m, bitpos n) {
+    if (m == n) {
+      return *this;
+    }
+    if (m < 0 || BITS <= m || n < m || BITS < n) {
+      throw std::out_of_range("qset.reset(m,n)");
+    }
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      b[i] &= ~word_range(m, n, i);
+    }
+    return *this;
+  }
+
+  // Clear bits a, b, c, ....
+  inline constexpr qSet& reset(std::initializer_list<bitpos> list) {
+    for (bitpos i : list) {
+      this->reset(i);
+    }
+    return *this;
+  }
+
+  // Toggle all the bits.
+  inline constexpr qSet& flip() {
+    *this = fast_not();
+    return *this;
+  }
+
+  // Toggle the indicated bit.
+  inline constexpr qSet& flip(bitpos pos) {
+    if (pos < 0 || 64 * QUADWORDS <= pos) {
+      throw std::out_of_range("qset.flip(pos)");
+    }
+    b[pos >> 6] ^= 1ULL << (pos & 0x3F);
+    return *this;
+  }
+
+  // Toggle the range of bits [m..n-1].
+  inline constexpr qSet& flip(bitpos m, bitpos n) {
+    if (m == n) {
+      return *this;
+    }
+    if (m < 0 || BITS <= m || n < m || BITS < n) {
+      throw std::out_of_range("qset.flip(m,n)");
+    }
+    for (bitpos i = 0; i < QUADWORDS; ++i) {
+      b[i] ^= word_range(m, n, i);
+    }
+    return *this;
+  }
+
+  // Toggle bits a, b, c, ....
+  inline constexpr qSet& flip(std::initializer_list<bitpos> list) {
+    for (bitpos i : list) {
+      this->flip(i);
+    }
+    return *this;
+  }
+
+  // Print a representation of the set; for example: {1, 3..5, 8, 10, 12}
+  std::ostream& print(std::ostream &out) {
+    return out << *this;
+  }
+
+  // Return a string representation of the set; for example: {1, 3..5, 8, 12}
+  std::string to_string() const {
+    return ::to_string(*this);
+  }
+
+private:
+  // The helpers below take the `words` index sequence, and expand to one
+  // initializer per quadword.
+
+  template<size_t... I>
+  static inline constexpr qSet universe(std::index_sequence<I...>) {
+    return qSet{ (I + 1 < QUADWORDS ? ~0ULL : top_mask())... };
+  }
+
+  template<size_t... I>
+  inline constexpr qSet clean(std::index_sequence<I...>) const {
+    return qSet{ (I + 1 < QUADWORDS ? b[I] : b[I] & top_mask())... };
+  }
+
+  template<size_t... I>
+  inline constexpr qSet fast_lsh(bitpos n, std::index_sequence<I...>) const {
+    return qSet{ lsh_word(n, I)... };
+  }
+
+  template<size_t... I>
+  inline constexpr qSet rsh(bitpos n, std::index_sequence<I...>) const {
+    return qSet{ rsh_word(n, I)... };
+  }
+
+  template<bitpos n, size_t... I>
+  inline constexpr qSet fast_shl(std::index_sequence<I...>) const {
+    return qSet{ qset_shl_word<n>(*this, I)... };
+  }
+
+  template<bitpos n, size_t... I>
+  inline constexpr qSet shr(std::index_sequence<I...>) const {
+    return qSet{ qset_shr_word<n>(*this, I)... };
+  }
+
+  template<size_t... I>
+  inline constexpr qSet reversed_words(std::index_sequence<I...>) const {
+    return qSet{ reverseBits(b[QUADWORDS - 1 - I])... };
+  }
+
+  template<size_t... I>
+  inline constexpr qSet and_(qSet o, std::index_sequence<I...>) const {
+    return qSet{ (b[I] & o.b[I])... };
+  }
+
+  template<size_t... I>
+  inline constexpr qSet or_(qSet o, std::index_sequence<I...>) const {
+    return qSet{ (b[I] | o.b[I])... };
+  }
+
+  template<size_t... I>
+  inline constexpr qSet xor_(qSet o, std::index_sequence<I...>) const {
+    return qSet{ (b[I] ^ o.b[I])... };
+  }
+
+  template<size_t... I>
+  inline constexpr qSet andnot_(qSet o, std::index_sequence<I...>) const {
+    return qSet{ (b[I] & ~o.b[I])... };
+  }
+
+  template<size_t... I>
+  inline constexpr qSet not_(std::index_sequence<I...>) const {
+    return qSet{ (~b[I])... };
+  }
+
+  // Returns word i of this set shifted left by n bits.
+  inline constexpr uint64_t lsh_word(bitpos n, bitpos i) const {
+    bitpos j = i - (n >> 6), bits = n & 0x3F;
+    return j < 0 ? 0 :
+      (b[j] << bits) | (bits != 0 && j > 0 ? b[j - 1] >> (64 - bits) : 0);
+  }
+
+  // Returns word i of this set shifted right by n bits.
+  inline constexpr uint64_t rsh_word(bitpos n, bitpos i) const {
+    bitpos j = i + (n >> 6), bits = n & 0x3F;
+    return j >= QUADWORDS ? 0 :
+      (b[j] >> bits) |
+      (bits != 0 && j + 1 < QUADWORDS ? b[j + 1] << (64 - bits) : 0);
+  }
+
+  // Returns the mask of the bits of the highest quadword that are in use.
+  static inline constexpr uint64_t top_mask() {
+    return bit_mask(0, BITS - 1 - 64 * (QUADWORDS - 1));
+  }
+
+  // Returns the bits of [m..n-1] that fall in quadword q.
+  static inline constexpr uint64_t word_range(bitpos m, bitpos n, bitpos q) {
+    return (n <= q * 64 || (q + 1) * 64 <= m) ? 0 :
+      bit_mask(m <= q * 64 ? 0 : m - q * 64,
+               (q + 1) * 64 <= n ? 63 : n - 1 - q * 64);
+  }
+
+};
+
+static_assert (std::is_pod< qset<384,6> >::value, "qset<BITS,Q> must be POD");
+
+#endif /* __QSETN_H__ */
@@ -1,6 +1,8 @@
 #ifndef __QUADSET_H__
 #define __QUADSET_H__ 1
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include "../panic/panic.h"
 
@@ -8,10 +10,11 @@
 // ================
 // The quadset type represents a set of small integers, similar to std::bitset.
 // However, instead of being infinitely variable in size, quadsets are
-// restricted to at most 256 bits.
+// restricted to at most 384 bits.
 //
 // A quadset inherits from one of four template specializations, having
-// capacities of 1, 2, 3, or 4 quadwords (i.e., 64, 128, 192, or 256 bits).
+// capacities of 1, 2, 3, or 4 quadwords (i.e., 64, 128, 192, or 256 bits),
+// or from the generic qset template, for 5 or 6 quadwords (320 or 384 bits).
 //
 // All methods (except for assignment operators) pass quadsets by value, not by
 // reference. If your set is too big to be passed by value, consider using
@@ -55,11 +58,11 @@
 // The Bitpos Type
 // ===============
 // The bitpos type represents an element of a quadset, and is putatively a
-// value between 0 and 255, inclusive.  Since the elements of quadsets are
-// constrained to this range, uint8_t would be large enough to store any
-// element. However, -1 and 256 are useful as off-the-end inputs, even though
-// they can't be stored in a quadset.  So instead, we use the next-larger
-// signed type instead.
+// value between 0 and 383, inclusive.  Since the elements of quadsets are
+// constrained to this range, a 16-bit type would be large enough to store any
+// element. Also, -1 and 384 are useful as off-the-end inputs, even though
+// they can't be stored in a quadset; so we use a signed type of at least
+// 16 bits.
 typedef int_fast16_t bitpos;
 
 
@@ -85,10 +88,14 @@ constexpr uint64_t bit_mask(int m, int n) {
 //   qset<BITS,3>   <--+----  quadset<BITS>
 //                     |      
 //   qset<BITS,4>   <--+      
+//                     |
+//   qset<BITS,Q>   <--+
 //
 // 
 // qset<BITS,1>, qset<BITS,2>, qset<BITS,3>, and qset<BITS,4> are the four
 // template specializations for handling capacities of 1, 2, 3, and 4 quads.
+// qset<BITS,Q> is the generic template (see qsetn.h), which handles 5 and 6
+// quads. If QUADSET_GENERIC is defined, it handles every capacity.
 
 
 // Forward declaration of qset<BITS,QUADWORDS>.
@@ -104,9 +111,91 @@ template<bitpos BITS>
 std::string to_string(qset<BITS> set);
 
 
+// If the compiler targets AVX2, qset<BITS,3> and qset<BITS,4> can convert to
+// and from a 256-bit register form, qset<BITS,2> to and from a 128-bit one,
+// and the AVX2 kernels in qset_avx2.h are available. Define QUADSET_NO_AVX2 to use only the scalar code.
+#if defined(__AVX2__) && !defined(QUADSET_NO_AVX2) && !defined(QUADSET_GENERIC)
+#define QUADSET_AVX2 1
+#endif
+
+
+#include "../quadset/qsetn.h"
+#ifndef QUADSET_GENERIC
 #include "../quadset/qset1.h"
 #include "../quadset/qset2.h"
 #include "../quadset/qset3.h"
+#include "../quadset/qset4.h"
+#endif
+
+
+// quadset_iterator<BITS> is an input iterator over the elements of a
+// qset<BITS>, in increasing order. It holds a copy of the set, the index of
+// the current quadword, and the not-yet-visited bits of that quadword. Each
+// step clears the lowest of those bits, and moves on to the next nonempty
+// quadword when they run out, so iterating over a set costs one step per
+// element plus one per quadword. Any garbage in the unused bits of the set
+// (see "Fast and Slow Operators", above) is ignored. operator* returns the
+// element by value, so it is an input iterator rather than a forward one.
+template<bitpos BITS>
+class quadset_iterator {
+public:
+  typedef std::input_iterator_tag iterator_category;
+  typedef bitpos value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef const bitpos* pointer;
+  typedef bitpos reference;
+
+  // Returns an iterator positioned at the first element of set that is in
+  // quadword q or later. If q is the number of quadwords, returns the end.
+  inline quadset_iterator(qset<BITS> set, bitpos q)
+    : set(set), q(q), bits(load(set, q)) {
+    skip_empty_words();
+  }
+
+  inline bitpos operator*() const {
+    return q * 64 + lowestBitPosition(bits);
+  }
+
+  inline quadset_iterator& operator++() {
+    bits &= bits - 1;
+    skip_empty_words();
+    return *this;
+  }
+
+  inline quadset_iterator operator++(int) {
+    quadset_iterator result = *this;
+    ++*this;
+    return result;
+  }
+
+  inline bool operator==(const quadset_iterator &other) const {
+    return q == other.q && bits == other.bits;
+  }
+
+  inline bool operator!=(const quadset_iterator &other) const {
+    return !this->operator==(other);
+  }
+
+private:
+  static constexpr bitpos QUADWORDS = (BITS+63) / 64;
+
+  qset<BITS> set;
+  bitpos q;
+  uint64_t bits;
+
+  static inline uint64_t load(qset<BITS> set, bitpos q) {
+    return q < QUADWORDS - 1 ? set.word(q) :
+           q == QUADWORDS - 1 ? set.word(q) & (~0ULL >> (63 - (BITS-1) % 64)) :
+           0;
+  }
+
+  inline void skip_empty_words() {
+    while (bits == 0 && q < QUADWORDS) {
+      ++q;
+      bits = load(set, q);
+    }
+  }
+};
 
 
 // quadset<BITS> is a subclass of the right-sized specialization.
@@ -191,6 +280,112 @@ public:
     return this->qSet::to_ullong();
   }
 
+  inline constexpr bool intersects(quadSet other) const {
+    return this->qSet::intersects(other);
+  }
+
+  inline constexpr bool is_subset_of(quadSet other) const {
+    return this->qSet::is_subset_of(other);
+  }
+
+  inline constexpr bool any_andnot(quadSet other) const {
+    return this->qSet::any_andnot(other);
+  }
+
+  inline bitpos count_and(quadSet other) const {
+    return this->qSet::count_and(other);
+  }
+
+  inline bool count_at_least(bitpos k) const {
+    return this->qSet::count_at_least(k);
+  }
+
+  inline bool union_changed(quadSet other) {
+    return this->qSet::union_changed(other);
+  }
+
+  // Iteration over the elements of the set, in increasing order. For example:
+  //   for (bitpos p : set) { ... }
+  inline quadset_iterator<BITS> begin() const {
+    return quadset_iterator<BITS>(*this, 0);
+  }
+
+  inline quadset_iterator<BITS> end() const {
+    return quadset_iterator<BITS>(qSet{0}, (BITS+63) / 64);
+  }
+
+  template<bitpos n>
+  inline constexpr quadSet shl() const {
+    return quadSet{ this->qSet::template shl<n>() };
+  }
+
+  template<bitpos n>
+  inline constexpr quadSet fast_shl() const {
+    return quadSet{ this->qSet::template fast_shl<n>() };
+  }
+
+  template<bitpos n>
+  inline constexpr quadSet shr() const {
+    return quadSet{ this->qSet::template shr<n>() };
+  }
+
+  inline constexpr quadSet reverse() const {
+    return quadSet{ this->qSet::reverse() };
+  }
+
+  inline quadSet branchless_lsh(bitpos n) const {
+    return quadSet{ this->qSet::branchless_lsh(n) };
+  }
+
+  inline quadSet fast_branchless_lsh(bitpos n) const {
+    return quadSet{ this->qSet::fast_branchless_lsh(n) };
+  }
+
+  inline quadSet branchless_rsh(bitpos n) const {
+    return quadSet{ this->qSet::branchless_rsh(n) };
+  }
+
+  // next_combination() returns the next larger set (in the order of
+  // operator<) with the same number of elements -- Gosper's hack, carried
+  // across quadwords -- or the empty set if there is none. Starting from
+  // range(0, k), it visits every k-element subset of 0..BITS-1.
+  // Requires any().
+  inline quadSet next_combination() const {
+    const bitpos low = this->min();
+    const quadSet vacant = ~*this & range(low, BITS);
+    if (vacant.none()) {
+      return quadSet{0};
+    }
+    const bitpos high = vacant.min();
+    return (*this - range(low, high)) | range(high, high + 1) |
+           range(0, high - low - 1);
+  }
+
+  // next_submask(mask) returns the next smaller subset of mask (in the order
+  // of operator<); it is the quadset version of (s - 1) & mask. Starting from
+  // mask, it visits every subset of mask, ending with the empty set.
+  // Requires any().
+  inline quadSet next_submask(quadSet mask) const {
+    const bitpos low = this->min();
+    return ((*this - range(low, low + 1)) | range(0, low)) & mask;
+  }
+
+  inline bitpos select(bitpos k) const {
+    return this->qSet::select(k);
+  }
+
+  inline bitpos rank(bitpos pos) const {
+    return this->qSet::rank(pos);
+  }
+
+  inline quadSet compress(quadSet mask) const {
+    return quadSet{ this->qSet::compress(mask) };
+  }
+
+  inline quadSet expand(quadSet mask) const {
+    return quadSet{ this->qSet::expand(mask) };
+  }
+
   inline constexpr quadSet operator<<(bitpos n) const {
     return quadSet{ this->qSet::operator<<(n) };
   }
@@ -324,6 +519,18 @@ public:
 };
 
 
+// std::hash<quadset<BITS>> lets quadsets be keys of std::unordered_map and
+// std::unordered_set. (operator< serves std::map and std::sort.)
+namespace std {
+template<bitpos BITS>
+struct hash< quadset<BITS> > {
+  inline size_t operator()(const quadset<BITS> &set) const {
+    return size_t(set.hash());
+  }
+};
+}
+
+
 template<bitpos BITS>
 std::ostream& operator<<(std::ostream &out, qset<BITS> set) {
   out << '{';
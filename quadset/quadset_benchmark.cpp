@@ -0,0 +1,269 @@
+#include <bitset>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <string.h>
+#include "quadset.h"
+#include "../hex/cellset.h"
+#include "samplesets.h"
+#include "../benchmark.h"
+
+// quadset_benchmark measures the quadset and cellset operations that the
+// winner() flood fills spend their time in, for cellset<N> at every board
+// size N from 1 to 13 and for quadset<BITS> at every capacity tier from one
+// to six quadwords. Each benchmark applies one operation to each of POOL
+// sample sets (from samplesets.h), so ns/op is the time for POOL operations.
+//
+// With an argument, quadset_benchmark runs just the benchmarks whose names
+// contain it; for example, "quadset_benchmark Neighbors" or
+// "quadset_benchmark '<cellset<13>>'".
+
+constexpr int POOL = 64;
+
+unsigned long long globalSum;
+const char *filter = nullptr;
+bool ranAny = false; // Whether a benchmark has run since the last break.
+
+// bits_of<Set>::value is the BITS of quadset<BITS> or of cellset<N,BITS>.
+template<class Set> struct bits_of;
+template<bitpos BITS> struct bits_of< quadset<BITS> > {
+  static constexpr bitpos value = BITS;
+};
+template<bitpos N, bitpos BITS> struct bits_of< cellset<N,BITS> > {
+  static constexpr bitpos value = BITS;
+};
+
+// Returns POOL nonempty sample sets of type Set.
+template<class Set>
+const std::vector<Set> &samples() {
+  static std::vector<Set> pool;
+  if (pool.empty()) {
+    constexpr bitpos BITS = bits_of<Set>::value;
+    for (auto &q : getTestSets<BITS>()->quadsets) {
+      if (q.any() && pool.size() < POOL) {
+        pool.push_back(Set{q});
+      }
+    }
+    for (bitpos i = 0; pool.size() < POOL; ++i) {
+      pool.push_back(Set{quadset<BITS>::make({i % BITS})});
+    }
+  }
+  return pool;
+}
+
+// Returns POOL shift distances, or cell numbers, in 0..BITS-1.
+template<class Set>
+const std::vector<bitpos> &positions() {
+  static std::vector<bitpos> pool;
+  if (pool.empty()) {
+    std::minstd_rand generator;
+    std::uniform_int_distribution<bitpos> dist(0, bits_of<Set>::value - 1);
+    for (int i = 0; i < POOL; ++i) {
+      pool.push_back(dist(generator));
+    }
+  }
+  return pool;
+}
+
+template<class Set>
+void Benchmark_LeftShift(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  const std::vector<bitpos> &shifts = positions<Set>();
+  Set acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      acc ^= sets[j] << shifts[j];
+    }
+  }
+  globalSum += acc.count();
+}
+
+template<class Set>
+void Benchmark_FastLeftShift(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  const std::vector<bitpos> &shifts = positions<Set>();
+  Set acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      acc ^= sets[j].fast_lsh(shifts[j]);
+    }
+  }
+  globalSum += acc.clean().count();
+}
+
+template<class Set>
+void Benchmark_RightShift(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  const std::vector<bitpos> &shifts = positions<Set>();
+  Set acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      acc ^= sets[j] >> shifts[j];
+    }
+  }
+  globalSum += acc.count();
+}
+
+template<class Set>
+void Benchmark_Neighbors(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  Set acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      acc ^= sets[j].neighbors();
+    }
+  }
+  globalSum += acc.count();
+}
+
+template<class Set>
+void Benchmark_FastNeighbors(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  Set acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      acc ^= sets[j].fast_neighbors();
+    }
+  }
+  globalSum += acc.clean().count();
+}
+
+template<class Set>
+void Benchmark_Count(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      localSum += sets[j].count();
+    }
+  }
+  globalSum += localSum;
+}
+
+template<class Set>
+void Benchmark_Min(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      localSum += sets[j].min();
+    }
+  }
+  globalSum += localSum;
+}
+
+template<class Set>
+void Benchmark_Max(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      localSum += sets[j].max();
+    }
+  }
+  globalSum += localSum;
+}
+
+// Compares each sample set with the next one, and with a copy of itself.
+template<class Set>
+void Benchmark_Equal(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  unsigned long long localSum = 0;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      localSum += sets[j] == sets[(j + (i & 1)) % POOL];
+    }
+  }
+  globalSum += localSum;
+}
+
+template<class Set>
+void Benchmark_SetReset(Benchmark &b) {
+  const std::vector<Set> &sets = samples<Set>();
+  const std::vector<bitpos> &cells = positions<Set>();
+  Set acc;
+  for (int i = 0; i < b.N; ++i) {
+    for (int j = 0; j < POOL; ++j) {
+      Set s = sets[j];
+      s.set(cells[j]).reset(cells[POOL - 1 - j]);
+      acc ^= s;
+    }
+  }
+  globalSum += acc.count();
+}
+
+// Runs the named benchmark for the set type called label, unless it is
+// filtered out.
+void run(std::string name, std::string label, Function f) {
+  name = "Benchmark_" + name + "<" + label + ">";
+  if (filter == nullptr || name.find(filter) != std::string::npos) {
+    Benchmark(name, f).run();
+    ranAny = true;
+  }
+}
+
+// Separates the results for one set type from the next.
+void endGroup() {
+  if (ranAny) {
+    std::cout << std::endl;
+    ranAny = false;
+  }
+}
+
+template<class Set>
+void runSetBenchmarks(std::string label) {
+  run("LeftShift", label, Benchmark_LeftShift<Set>);
+  run("FastLeftShift", label, Benchmark_FastLeftShift<Set>);
+  run("RightShift", label, Benchmark_RightShift<Set>);
+  run("Count", label, Benchmark_Count<Set>);
+  run("Min", label, Benchmark_Min<Set>);
+  run("Max", label, Benchmark_Max<Set>);
+  run("Equal", label, Benchmark_Equal<Set>);
+  run("SetReset", label, Benchmark_SetReset<Set>);
+}
+
+template<bitpos N>
+void runCellsetBenchmarks() {
+  const std::string label = "cellset<" + std::to_string(N) + ">";
+  runSetBenchmarks< cellset<N> >(label);
+  run("Neighbors", label, Benchmark_Neighbors< cellset<N> >);
+  run("FastNeighbors", label, Benchmark_FastNeighbors< cellset<N> >);
+  endGroup();
+}
+
+template<bitpos BITS>
+void runQuadsetBenchmarks() {
+  runSetBenchmarks< quadset<BITS> >("quadset<" + std::to_string(BITS) + ">");
+  endGroup();
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1) {
+    filter = argv[1];
+  }
+  std::cout << "ns/op is the time for " << POOL << " operations." << std::endl
+            << std::endl;
+
+  runCellsetBenchmarks<1>();
+  runCellsetBenchmarks<2>();
+  runCellsetBenchmarks<3>();
+  runCellsetBenchmarks<4>();
+  runCellsetBenchmarks<5>();
+  runCellsetBenchmarks<6>();
+  runCellsetBenchmarks<7>();
+  runCellsetBenchmarks<8>();
+  runCellsetBenchmarks<9>();
+  runCellsetBenchmarks<10>();
+  runCellsetBenchmarks<11>();
+  runCellsetBenchmarks<12>();
+  runCellsetBenchmarks<13>();
+
+  runQuadsetBenchmarks<64>();
+  runQuadsetBenchmarks<128>();
+  runQuadsetBenchmarks<192>();
+  runQuadsetBenchmarks<256>();
+  runQuadsetBenchmarks<320>();
+  runQuadsetBenchmarks<384>();
+  return 0;
+}
@@ -1,6 +1,7 @@
 #include <bitset>
 #include <iostream>
 #include <sstream>
+#include <unordered_set>
 #include <random>
 #include <functional>
 #include <vector>
@@ -20,7 +21,17 @@ typedef quadset<129> set129;
 typedef quadset<160> set160;
 typedef quadset<191> set191;
 typedef quadset<192> set192;
+typedef quadset<193> set193;
+typedef quadset<224> set224;
+typedef quadset<255> set255;
+typedef quadset<256> set256;
+typedef quadset<257> set257;
+typedef quadset<320> set320;
+typedef quadset<383> set383;
+typedef quadset<384> set384;
 typedef cellset<8>   cellset8;
+typedef cellset<16>  cellset16;
+typedef cellset<19>  cellset19;
 
 
 template<bitpos BITS>
@@ -65,6 +76,15 @@ void expect_op_result(
   }
 }
 
+// Checks that the compile-time shifts by n agree with the runtime shifts.
+template<bitpos n, bitpos BITS>
+void expect_constant_shifts(quadset<BITS> q) {
+  EXPECT_EQ(q << n, q.template shl<n>()) << q << " << " << n;
+  EXPECT_EQ(q.fast_lsh(n).clean(), q.template fast_shl<n>().clean())
+    << q << " fast_lsh " << n;
+  EXPECT_EQ(q >> n, q.template shr<n>()) << q << " >> " << n;
+}
+
 template<bitpos BITS>
 int loopCountBits(quadset<BITS> s) {
   int count = 0;
@@ -161,8 +181,109 @@ void testShift(std::string label, quadset<BITS> got, quadset<BITS> base, bitpos
 #undef SET
 #undef SIZE
 
+#define SET set193
+#define SIZE 193
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
+#define SET set224
+#define SIZE 224
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
+#define SET set255
+#define SIZE 255
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
+#define SET set256
+#define SIZE 256
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
+#define SET set257
+#define SIZE 257
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
+#define SET set320
+#define SIZE 320
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
+#define SET set383
+#define SIZE 383
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
+#define SET set384
+#define SIZE 384
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
 #define SET cellset8
 #define SIZE 64
 #include "quadset_test.inc"
 #undef SET
 #undef SIZE
+
+#define SET cellset16
+#define SIZE 256
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
+#define SET cellset19
+#define SIZE 361
+#include "quadset_test.inc"
+#undef SET
+#undef SIZE
+
+#ifdef QUADSET_AVX2
+// The AVX2 shift kernels must agree with the scalar shifts at every distance,
+// including whole-quadword and out-of-range distances.
+template<bitpos BITS>
+void testAvx2Shifts() {
+  typedef quadset<BITS> Set;
+  for (Set set : getTestSets<BITS>()->quadsets) {
+    quadvec v = set.to_quadvec();
+    for (bitpos n = 0; n <= 260; ++n) {
+      Set lsh{ Set::qSet::from_quadvec(avx2_lsh(v, n)) };
+      testShift("Avx2LeftShift", lsh, set, n, FAST);
+      EXPECT_EQ(set.fast_lsh(n), lsh) << n;
+      Set rsh{ Set::qSet::from_quadvec(avx2_rsh(v, n)) };
+      testShift("Avx2RightShift", rsh, set, -n, ACCURATE);
+      EXPECT_EQ(set >> n, rsh) << n;
+    }
+  }
+}
+
+TEST(Avx2, Shifts) {
+  testAvx2Shifts<129>();
+  testAvx2Shifts<160>();
+  testAvx2Shifts<192>();
+  testAvx2Shifts<193>();
+  testAvx2Shifts<255>();
+  testAvx2Shifts<256>();
+}
+
+TEST(Avx2, Predicates) {
+  typedef quadset<256> Set;
+  Set a = Set::make({0, 100, 255});
+  Set b = Set::make({1, 100});
+  EXPECT_FALSE(avx2_none(a.to_quadvec()));
+  EXPECT_TRUE(avx2_none(Set{0}.to_quadvec()));
+  EXPECT_FALSE(avx2_disjoint(a.to_quadvec(), b.to_quadvec()));
+  EXPECT_TRUE(avx2_disjoint((a - b).to_quadvec(), b.to_quadvec()));
+  EXPECT_TRUE(avx2_subset((a & b).to_quadvec(), b.to_quadvec()));
+  EXPECT_FALSE(avx2_subset(a.to_quadvec(), b.to_quadvec()));
+}
+#endif
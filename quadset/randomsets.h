@@ -0,0 +1,23 @@
+#ifndef __RANDOMSETS_H__
+#define __RANDOMSETS_H__ 1
+#include <random>
+#include "quadset.h"
+
+// randomSet<Set>(generator, size, percent) returns a Set in which each of the
+// elements 0..size-1 is present with probability percent/100. Set is a
+// quadset<BITS>, or a type like cellset<N> that is empty when default
+// constructed and has set(i); the tests of the hex sets use it for random
+// positions, as in randomSet< cellset<N> >(generator, N*N, 50).
+template<class Set>
+Set randomSet(std::minstd_rand &generator, bitpos size, int percent) {
+  std::uniform_int_distribution<int> dist(0, 99);
+  Set result;
+  for (bitpos i = 0; i < size; ++i) {
+    if (dist(generator) < percent) {
+      result.set(i);
+    }
+  }
+  return result;
+}
+
+#endif /* __RANDOMSETS_H__ */